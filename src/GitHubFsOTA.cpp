@@ -1,12 +1,9 @@
 #ifdef ESP8266
 #include <ESP8266WiFi.h>
-#include <ESP8266HTTPClient.h>
-#include <ESP8266httpUpdate.h>
+#include <Updater.h>
 #elif defined(ESP32)
 #include <WiFiClientSecure.h>
 #include <Update.h>
-#include <HTTPClient.h>
-#include <HTTPUpdate.h>
 #endif
 
 #include <ArduinoJson.h>
@@ -14,6 +11,9 @@
 #include "semver_extensions.h"
 #include "GitHubFsOTA.h"
 #include "common.h"
+#include "release_url.h"
+#include "preflight.h"
+#include "file_sync.h"
 
 GitHubFsOTA::GitHubFsOTA(
     String version,
@@ -28,67 +28,282 @@ GitHubFsOTA::GitHubFsOTA(
   _release_url = release_url;
   _filesystem_name = filesystem_name;
   _fetch_url_via_redirect = fetch_url_via_redirect;
+  _transport = &_default_transport;
+  _control = {false, false, 0, false, false, 1, nullptr, on_progress, this};
+  _arena = nullptr;
+  _arena_auto = false;
+  _sync_fs = nullptr;
+#ifdef ESP32
+  _ab_slots = false;
+  _remount = nullptr;
+  _mounted = nullptr;
+#endif
+}
 
-  Updater.rebootOnUpdate(false);
-#ifdef ESP8266
-  _x509.append(github_certificate);
-  _wifi_client.setTrustAnchors(&_x509);
-#elif defined(ESP32)
-  _wifi_client.setCACert(github_certificate);
+void GitHubFsOTA::set_transport(OtaTransport &transport)
+{
+  _transport = &transport;
+}
+
+OtaTransport &GitHubFsOTA::transport()
+{
+  return *_transport;
+}
+
+void GitHubFsOTA::on_event(ota_event_cb_t callback, void *ctx)
+{
+  _notifier.set_callback(callback, ctx);
+}
+
+void GitHubFsOTA::set_progress_interval(uint8_t percent, uint32_t interval_ms)
+{
+  _notifier.set_progress_interval(percent, interval_ms);
+}
+
+void GitHubFsOTA::on_progress(void *ctx, size_t current, size_t total, const update_stats_t &stats)
+{
+  static_cast<GitHubFsOTA *>(ctx)->notify(OTA_EVENT_PROGRESS, current, total, &stats);
+}
+
+void GitHubFsOTA::notify(ota_event_type_t type, uint32_t current, uint32_t total, const update_stats_t *stats)
+{
+  ota_event_t event = {type, current, total,
+                       stats ? stats->bytes_per_sec : 0,
+                       stats ? stats->throttled_ms : 0};
+  _notifier.notify(event);
+}
+
+void GitHubFsOTA::set_rate_limit(uint32_t bytes_per_sec)
+{
+  _control.rate_limit = bytes_per_sec;
+}
+
+void GitHubFsOTA::set_idle_only(bool idle_only)
+{
+  _control.idle_only = idle_only;
+}
+
+void GitHubFsOTA::set_busy(bool busy)
+{
+  _control.busy = busy;
+}
+
+#ifdef ESP32
+void GitHubFsOTA::set_parallel_streams(uint8_t streams)
+{
+  _control.streams = std::max(streams, (uint8_t)1);
+}
 #endif
 
-#ifdef LED_BUILTIN
-  Updater.setLedPin(LED_BUILTIN, LOW);
+void GitHubFsOTA::enable_file_sync(fs::FS &fs, String manifest_name, String pack_name)
+{
+  _sync_fs = &fs;
+  _manifest_name = manifest_name;
+  _pack_name = pack_name;
+}
+
+#ifdef ESP32
+bool GitHubFsOTA::enable_ab_slots(void (*remount)(const char *label))
+{
+  const char *TAG = "enable_ab_slots";
+  if (!fs_slots_available())
+  {
+    ESP_LOGE(TAG, "No partitions %s and %s\n", GITHUBOTA_FS_SLOT_A, GITHUBOTA_FS_SLOT_B);
+    return false;
+  }
+
+  _ab_slots = true;
+  _remount = remount;
+  // Mounted at boot, see fs_slots.h
+  _mounted = fs_slot_active();
+
+  // The image in the slot is newer than the one the firmware was built with
+  String version;
+  if (fs_slot_version(version))
+  {
+    ESP_LOGI(TAG, "Filesystem %s has version %s\n", _mounted, version.c_str());
+    release_version(_version);
+    _version = from_string(version.c_str());
+  }
+  return true;
+}
 #endif
-  Updater.onStart(update_started);
-  Updater.onEnd(update_finished);
-  Updater.onProgress(update_progress);
-  Updater.onError(update_error);
-  Updater.setFollowRedirects(HTTPC_FORCE_FOLLOW_REDIRECTS);
+
+void GitHubFsOTA::set_token(const String &token)
+{
+  _token = token;
+}
+
+#ifdef ESP32
+bool GitHubFsOTA::load_token()
+{
+  return token_load(_token);
+}
+#endif
+
+void GitHubFsOTA::enable_arena(size_t size, bool reserve)
+{
+  if (_arena)
+    return;
+
+  _arena_auto = size == 0;
+  _arena = new OtaArena(_arena_auto ? arena_size_for(false, _control.streams) : size, reserve);
 }
 
 void GitHubFsOTA::handle()
+{
+  // The installed version outlives the check, it must not be parsed into the
+  // arena, which is released when the check ends
+  char installed[RELEASE_TAG_SIZE] = "";
+  {
+    // Features enabled after enable_arena() count as well
+    if (_arena && _arena_auto)
+      _arena->resize(arena_size_for(false, _control.streams));
+    ArenaScope arena(_arena);
+    check(installed);
+  }
+
+  // Not offered again, A/B slots keep it across restarts as well
+  if (installed[0])
+  {
+    release_version(_version);
+    _version = from_string(tag_version(installed));
+  }
+}
+
+// Fills `installed` with the tag of the release written, if any
+void GitHubFsOTA::check(char *installed)
 {
   const char *TAG = "handle";
+  notify(OTA_EVENT_CHECKING);
   synchronize_system_time();
 
-  String base_url = _fetch_url_via_redirect ?
-    get_updated_base_url_via_redirect(_wifi_client, _release_url) :
-    get_updated_base_url_via_api(_wifi_client, _release_url);
+  // The asset metadata feeds the pre-flight checks and private downloads
+  release_asset_t asset;
+  asset.size = 0;
+  asset.has_digest = false;
+  // File sync needs the manifest digest, which only the API reports
+  String base_url = _fetch_url_via_redirect && !_sync_fs ?
+    get_updated_base_url_via_redirect(*_transport, _release_url) :
+    get_updated_base_url_via_api(*_transport, _release_url, _sync_fs ? _manifest_name : _filesystem_name,
+                                 &asset, nullptr, _token);
   ESP_LOGI(TAG, "base_url %s\n", base_url.c_str());
 
-  auto last_slash = base_url.lastIndexOf('/', base_url.length() - 2);
-  auto semver_str = base_url.substring(last_slash + 1);
-  auto _new_version = from_string(semver_str.c_str());
+  release_ref_t release;
+  bool found = parse_release_url(base_url.c_str(), release);
+  auto _new_version = from_string(found ? tag_version(release.tag) : "0.0.0");
+  bool required = update_required(_new_version, _version);
+  release_version(_new_version);
 
-  if (update_required(_new_version, _version))
+  // File sync fetches only what changed, the image size does not apply
+  String reason;
+#ifdef ESP32
+  const char *slot = _ab_slots ? fs_slot_inactive() : nullptr;
+  // Switched without a remount, the new slot is in use until the restart
+  if (required && slot && strcmp(slot, _mounted) == 0)
   {
-    auto result = update_filesystem(base_url + _filesystem_name);
+    ESP_LOGE(TAG, "FS update to %s rejected: %s is mounted, restart first\n", release.tag, slot);
+    notify(OTA_EVENT_REJECTED);
+    return;
+  }
+#else
+  const char *slot = nullptr;
+#endif
+  if (required && !_sync_fs && !preflight_check(asset, U_FILESYSTEM, reason, slot))
+  {
+    ESP_LOGE(TAG, "FS update to %s rejected: %s\n", release.tag, reason.c_str());
+    notify(OTA_EVENT_REJECTED);
+    return;
+  }
 
-    if (result != HTTP_UPDATE_OK)
+  if (required)
+  {
+    notify(OTA_EVENT_STARTED);
+    bool ok = _sync_fs ?
+      sync_release_files(base_url, asset) :
+      update_filesystem(release, asset);
+    if (!ok)
     {
-      ESP_LOGI(TAG, "FS update failed: %s\n", Updater.getLastErrorString().c_str());
+      ESP_LOGI(TAG, "FS update failed\n");
+      notify(OTA_EVENT_FAILED);
       return;
     }
 
     ESP_LOGI(TAG, "FS update successful.\n");
+    strcpy(installed, release.tag);
+    notify(OTA_EVENT_FINISHED);
     // ESP.restart();
     return;
   }
 
   ESP_LOGI(TAG, "No updates found\n");
+  ESP_LOGI(TAG, "Connections opened: %u, reused: %u\n",
+           _transport->connections_opened(), _transport->connections_reused());
+  notify(OTA_EVENT_NO_UPDATE);
 }
 
-HTTPUpdateResult GitHubFsOTA::update_filesystem(String url)
+bool GitHubFsOTA::update_filesystem(const release_ref_t &release, const release_asset_t &asset)
 {
   const char *TAG = "update_filesystem";
-  ESP_LOGI(TAG, "Download URL: %s\n", url.c_str());
+  char url[RELEASE_URL_SIZE];
+  const uint8_t *sha256 = asset.has_digest ? asset.sha256 : nullptr;
+#ifdef ESP32
+  // The mounted slot is left alone, the image goes into the other one
+  _control.partition = _ab_slots ? fs_slot_inactive() : nullptr;
+#endif
 
-#ifdef ESP8266
-  auto result = Updater.updateFS(_wifi_client, url);
-#elif defined(ESP32)
-  auto result = Updater.updateSpiffs(_wifi_client, url);
+  bool ok;
+  if (_token.length() == 0)
+  {
+    ok = build_download_url(release, _filesystem_name.c_str(), url, sizeof(url)) &&
+         download_update(*_transport, url, sha256, U_FILESYSTEM, &_control);
+  }
+  else if (asset.url.length() == 0)
+  {
+    ESP_LOGE(TAG, "No asset %s in the release\n", _filesystem_name.c_str());
+    ok = false;
+  }
+  else
+  {
+    ok = download_update(*_transport, asset.url, sha256, U_FILESYSTEM, &_control, _token);
+  }
+  ESP_LOGI(TAG, "%s\n", ok ? "HTTP_UPDATE_OK" : "HTTP_UPDATE_FAILED");
+
+#ifdef ESP32
+  const char *slot = _control.partition;
+  _control.partition = nullptr;
+  if (ok && slot)
+  {
+    ok = fs_slot_activate(slot, tag_version(release.tag));
+    if (ok && _remount)
+    {
+      _remount(slot);
+      _mounted = slot;
+    }
+  }
 #endif
-  print_update_result(Updater, result, TAG);
-  return result;
-}
\ No newline at end of file
+  return ok;
+}
+
+bool GitHubFsOTA::sync_release_files(String base_url, const release_asset_t &manifest)
+{
+  const char *TAG = "sync_release_files";
+  if (!manifest.has_digest)
+  {
+    ESP_LOGE(TAG, "No digest for %s in the release\n", _manifest_name.c_str());
+    return false;
+  }
+  if (_token.length() == 0)
+    return sync_files(*_transport, *_sync_fs, base_url + _manifest_name, base_url + _pack_name,
+                      manifest.sha256, &_control);
+
+  // The pack needs its own asset URL
+  release_asset_t pack;
+  get_updated_base_url_via_api(*_transport, _release_url, _pack_name, &pack, nullptr, _token);
+  if (manifest.url.length() == 0 || pack.url.length() == 0)
+  {
+    ESP_LOGE(TAG, "No assets %s and %s in the release\n", _manifest_name.c_str(), _pack_name.c_str());
+    return false;
+  }
+  return sync_files(*_transport, *_sync_fs, manifest.url, pack.url, manifest.sha256, &_control, _token);
+}
@@ -3,13 +3,20 @@
 
 #ifdef ESP8266
 #include <ESP8266WiFi.h>
-#include <ESP8266httpUpdate.h>
 #elif defined(ESP32)
 #include <WiFiClientSecure.h>
-#include <HTTPUpdate.h>
 #endif
 
+#include <FS.h>
+
 #include "semver.h"
+#include "transport.h"
+#include "common.h"
+#include "arena.h"
+#include "token_store.h"
+#include "release_url.h"
+#include "fs_slots.h"
+#include "events.h"
 
 class GitHubFsOTA
 {
@@ -22,22 +29,76 @@ public:
 
   void handle();
 
-private:
-#ifdef ESP8266
-  ESP8266HTTPUpdate Updater;
-#elif defined(ESP32)
-  HTTPUpdate Updater;
+  // Route all traffic through another link (Ethernet, cellular, ...).
+  // The transport must outlive the updater.
+  void set_transport(OtaTransport &transport);
+  // Connection pool settings and opened/reused counters
+  OtaTransport &transport();
+
+  // Events of this updater, see GitHubOTA::on_event()
+  void on_event(ota_event_cb_t callback, void *ctx = nullptr);
+  void set_progress_interval(uint8_t percent, uint32_t interval_ms);
+
+  // Airtime budgeting for the download: cap in bytes/s (0 = unlimited) and an
+  // idle-only mode that holds the transfer back while set_busy(true) is in effect
+  void set_rate_limit(uint32_t bytes_per_sec);
+  void set_idle_only(bool idle_only);
+  void set_busy(bool busy);
+#ifdef ESP32
+  // See GitHubOTA::set_parallel_streams()
+  void set_parallel_streams(uint8_t streams);
+#endif
+
+  // Update individual files listed in the release manifest instead of the whole
+  // image (see file_sync.h); files not in the manifest are kept
+  void enable_file_sync(fs::FS &fs, String manifest_name = "filesystem.manifest", String pack_name = "filesystem.pack");
+
+#ifdef ESP32
+  // A/B filesystem partitions (see fs_slots.h): images are written into the
+  // inactive slot while the active one stays mounted, so handle() may run in a
+  // low priority task without disturbing the application. Once verified the
+  // slot is switched and `remount` is called with its label, otherwise the new
+  // slot is mounted on the next boot and no further update is written until
+  // then. The version of the image is stored with the switch and replaces the
+  // one given to the constructor. Not used by file sync.
+  bool enable_ab_slots(void (*remount)(const char *label) = nullptr);
+#endif
+
+  // Private repositories, see GitHubOTA::set_token()
+  void set_token(const String &token);
+#ifdef ESP32
+  bool load_token();
 #endif
 
-  HTTPUpdateResult update_filesystem(String url);
+  // Serve the allocations of each check from one arena (see GitHubOTA)
+  void enable_arena(size_t size = GITHUBOTA_ARENA_SIZE, bool reserve = true);
+
+private:
+  void check(char *installed);
+  bool update_filesystem(const release_ref_t &release, const release_asset_t &asset);
+  bool sync_release_files(String base_url, const release_asset_t &manifest);
+  void notify(ota_event_type_t type, uint32_t current = 0, uint32_t total = 0, const update_stats_t *stats = nullptr);
+  static void on_progress(void *ctx, size_t current, size_t total, const update_stats_t &stats);
 
   semver_t _version;
   String _release_url;
   String _filesystem_name;
   bool _fetch_url_via_redirect;
-  WiFiClientSecure _wifi_client;
-#ifdef ESP8266
-  X509List _x509;
+  String _token;
+  WiFiSecureTransport _default_transport;
+  OtaTransport *_transport;
+  update_control_t _control;
+  OtaNotifier _notifier;
+  OtaArena *_arena;
+  // Sized from the enabled features at every check
+  bool _arena_auto;
+  fs::FS *_sync_fs;
+  String _manifest_name;
+  String _pack_name;
+#ifdef ESP32
+  bool _ab_slots;
+  void (*_remount)(const char *label);
+  const char *_mounted;
 #endif
 };
 
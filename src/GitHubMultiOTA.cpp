@@ -0,0 +1,377 @@
+#ifdef ESP8266
+#include <ESP8266WiFi.h>
+#include <ESP8266HTTPClient.h>
+#elif defined(ESP32)
+#include <WiFiClientSecure.h>
+#include <HTTPClient.h>
+#endif
+
+#include <ArduinoJson.h>
+#include "semver_extensions.h"
+#include "GitHubMultiOTA.h"
+#include "common.h"
+#include "http.h"
+#include "sha256.h"
+#include "rtc_cache.h"
+
+#define GITHUB_GRAPHQL_URL "https://api.github.com/graphql"
+
+GitHubMultiOTA::GitHubMultiOTA(const String &token)
+{
+  _token = token;
+  _transport = &_default_transport;
+  _control = {false, false, 0, false, false, 1, nullptr, on_progress, this};
+  _count = 0;
+  _check_interval_ms = 0;
+  _last_check = 0;
+  _checked = false;
+  _last_ntp = 0;
+}
+
+void GitHubMultiOTA::set_transport(OtaTransport &transport)
+{
+  _transport = &transport;
+}
+
+OtaTransport &GitHubMultiOTA::transport()
+{
+  return *_transport;
+}
+
+void GitHubMultiOTA::set_check_interval(uint32_t seconds)
+{
+  _check_interval_ms = seconds * 1000;
+}
+
+void GitHubMultiOTA::on_event(ota_event_cb_t callback, void *ctx)
+{
+  _notifier.set_callback(callback, ctx);
+}
+
+void GitHubMultiOTA::set_progress_interval(uint8_t percent, uint32_t interval_ms)
+{
+  _notifier.set_progress_interval(percent, interval_ms);
+}
+
+int GitHubMultiOTA::add(const String &repo, const String &version, const String &asset_name, int command)
+{
+  const char *TAG = "GitHubMultiOTA::add";
+
+  // Only one image can be the running firmware
+  for (size_t i = 0; i < _count && command == U_FLASH; i++)
+  {
+    if (_components[i].command == U_FLASH)
+    {
+      ESP_LOGE(TAG, "There is a firmware component already\n");
+      return -1;
+    }
+  }
+
+  int index = add_component(repo, version, asset_name);
+  if (index >= 0)
+    _components[index].command = command;
+  return index;
+}
+
+int GitHubMultiOTA::add(const String &repo, const String &version, const String &asset_name, OtaSink &sink)
+{
+  int index = add_component(repo, version, asset_name);
+  if (index >= 0)
+  {
+    _components[index].command = -1;
+    _components[index].sink = &sink;
+  }
+  return index;
+}
+
+int GitHubMultiOTA::add_component(const String &repo, const String &version, const String &asset_name)
+{
+  const char *TAG = "GitHubMultiOTA::add";
+
+  if (_count >= GITHUBOTA_MULTI_MAX)
+  {
+    ESP_LOGE(TAG, "More than %u components\n", GITHUBOTA_MULTI_MAX);
+    return -1;
+  }
+
+  ota_component_t &component = _components[_count];
+  if (!parse_repo_url(repo.c_str(), component.repo))
+  {
+    ESP_LOGE(TAG, "Not a repository: %s\n", repo.c_str());
+    return -1;
+  }
+  component.version = from_string(version.c_str());
+  component.asset_name = asset_name;
+  component.sink = nullptr;
+  component.asset_id = 0;
+  component.size = 0;
+  component.changed = false;
+  return _count++;
+}
+
+void GitHubMultiOTA::handle()
+{
+  const char *TAG = "handle";
+  if (_checked && millis() - _last_check < _check_interval_ms)
+    return;
+  _checked = true;
+  _last_check = millis();
+
+  notify(OTA_EVENT_CHECKING);
+  prepare_clock();
+
+  if (!check())
+  {
+    notify(OTA_EVENT_FAILED);
+    return;
+  }
+
+  // The firmware goes last, it restarts the device
+  ota_component_t *firmware = nullptr;
+  bool updated = false;
+  for (size_t i = 0; i < _count; i++)
+  {
+    ota_component_t &component = _components[i];
+    if (!component.changed)
+      continue;
+    if (component.command == U_FLASH)
+    {
+      firmware = &component;
+      continue;
+    }
+
+    updated = true;
+    notify(OTA_EVENT_STARTED);
+    if (!install(component))
+    {
+      notify(OTA_EVENT_FAILED);
+      continue;
+    }
+
+    // The installed release is the running one from now on
+    release_version(component.version);
+    component.version = from_string(tag_version(component.repo.tag));
+    notify(OTA_EVENT_FINISHED);
+  }
+
+  if (firmware)
+  {
+    notify(OTA_EVENT_STARTED);
+    if (!install(*firmware))
+    {
+      notify(OTA_EVENT_FAILED);
+      return;
+    }
+
+    ESP_LOGI(TAG, "Update successful. Restarting...\n");
+    notify(OTA_EVENT_FINISHED);
+    delay(1000);
+    ESP.restart();
+  }
+
+  if (!updated)
+  {
+    ESP_LOGI(TAG, "No updates found\n");
+    notify(OTA_EVENT_NO_UPDATE);
+  }
+}
+
+// Certificate validation needs the clock; NTP only runs while it is unset and
+// once every GITHUBOTA_NTP_INTERVAL_S, not on every check
+void GitHubMultiOTA::prepare_clock()
+{
+  time_t now = time(nullptr);
+  if (now > 8 * 3600 * 2 && _last_ntp != 0 && (uint32_t)now - _last_ntp < GITHUBOTA_NTP_INTERVAL_S)
+    return;
+
+  synchronize_system_time();
+  _last_ntp = time(nullptr);
+}
+
+// Appends `value` as the contents of a JSON string
+static void json_escape(String &out, const char *value)
+{
+  for (const char *p = value; *p; p++)
+  {
+    if (*p == '"' || *p == '\\')
+    {
+      out += '\\';
+      out += *p;
+    }
+    else if ((uint8_t)*p < 0x20)
+    {
+      char escaped[7];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", (uint8_t)*p);
+      out += escaped;
+    }
+    else
+    {
+      out += *p;
+    }
+  }
+}
+
+// One GraphQL query for the latest release of every component, each under
+// its own alias c0, c1, ... Owners, repositories and asset names are passed as
+// variables, so they only need escaping as JSON strings.
+String GitHubMultiOTA::query()
+{
+  String query = "{\"query\":\"query(";
+  for (size_t i = 0; i < _count; i++)
+  {
+    String n(i);
+    query += "$o" + n + ":String!,$r" + n + ":String!,$a" + n + ":String!,";
+  }
+  query += "){";
+  for (size_t i = 0; i < _count; i++)
+  {
+    String n(i);
+    query += "c" + n + ":repository(owner:$o" + n + ",name:$r" + n +
+             "){latestRelease{tagName releaseAssets(first:1,name:$a" + n + "){nodes{size databaseId}}}} ";
+  }
+  query += "}\",\"variables\":{";
+  for (size_t i = 0; i < _count; i++)
+  {
+    const ota_component_t &component = _components[i];
+    String n(i);
+    query += (i ? ",\"o" : "\"o") + n + "\":\"";
+    json_escape(query, component.repo.owner);
+    query += "\",\"r" + n + "\":\"";
+    json_escape(query, component.repo.repo);
+    query += "\",\"a" + n + "\":\"";
+    json_escape(query, component.asset_name.c_str());
+    query += "\"";
+  }
+  query += "}}";
+  return query;
+}
+
+bool GitHubMultiOTA::check()
+{
+  const char *TAG = "GitHubMultiOTA::check";
+
+  OtaHttp https(*_transport);
+  github_authorize(https, _token, false);
+  int httpCode = https.post(GITHUB_GRAPHQL_URL, query());
+  if (httpCode != HTTP_CODE_OK)
+  {
+    ESP_LOGI(TAG, "[HTTPS] POST... failed, httpCode: %d\n", httpCode);
+    https.end();
+    return false;
+  }
+
+  StaticJsonDocument<192> filter;
+  filter["latestRelease"]["tagName"] = true;
+  filter["latestRelease"]["releaseAssets"]["nodes"][0]["size"] = true;
+  filter["latestRelease"]["releaseAssets"]["nodes"][0]["databaseId"] = true;
+
+  // Aliases come back in query order, each is parsed on its own so memory
+  // does not grow with the number of components
+  bool ok = true;
+  for (size_t i = 0; i < _count && ok; i++)
+  {
+    ota_component_t &component = _components[i];
+    component.changed = false;
+
+    char alias[12];
+    snprintf(alias, sizeof(alias), "\"c%u\":", (unsigned)i);
+    ok = https.stream().find(alias);
+    if (!ok)
+    {
+      ESP_LOGE(TAG, "No result for %s/%s\n", component.repo.owner, component.repo.repo);
+      break;
+    }
+
+    StaticJsonDocument<384> doc;
+    auto result = deserializeJson(doc, https.stream(), DeserializationOption::Filter(filter));
+    if (result != DeserializationError::Ok)
+    {
+      ESP_LOGI(TAG, "deserializeJson error %s\n", result.c_str());
+      ok = false;
+      break;
+    }
+
+    const char *tag = doc["latestRelease"]["tagName"];
+    JsonObject asset = doc["latestRelease"]["releaseAssets"]["nodes"][0];
+    if (!tag || asset.isNull() || strlen(tag) >= sizeof(component.repo.tag))
+    {
+      ESP_LOGI(TAG, "%s/%s: no release with %s\n", component.repo.owner, component.repo.repo,
+               component.asset_name.c_str());
+      continue;
+    }
+
+    strncpy(component.repo.tag, tag, sizeof(component.repo.tag));
+    component.asset_id = asset["databaseId"];
+    component.size = asset["size"];
+    semver_t latest = from_string(tag_version(tag));
+    component.changed = update_required(latest, component.version);
+    release_version(latest);
+    ESP_LOGI(TAG, "%s/%s: %s%s\n", component.repo.owner, component.repo.repo, tag,
+             component.changed ? " (new)" : "");
+  }
+
+  https.end();
+  return ok;
+}
+
+// SHA-256 of the asset from its REST record, false when GitHub has none
+bool GitHubMultiOTA::fetch_digest(const char *url, uint8_t sha256[SHA256_DIGEST_SIZE])
+{
+  const char *TAG = "GitHubMultiOTA::fetch_digest";
+
+  OtaHttp https(*_transport);
+  github_authorize(https, _token, false);
+  int httpCode = https.get(url);
+  if (httpCode != HTTP_CODE_OK)
+  {
+    ESP_LOGI(TAG, "[HTTPS] GET... failed, httpCode: %d\n", httpCode);
+    https.end();
+    return false;
+  }
+
+  StaticJsonDocument<32> filter;
+  filter["digest"] = true;
+  StaticJsonDocument<192> doc;
+  auto result = deserializeJson(doc, https.stream(), DeserializationOption::Filter(filter));
+  https.end();
+  return result == DeserializationError::Ok && parse_sha256_digest(doc["digest"], sha256);
+}
+
+bool GitHubMultiOTA::install(ota_component_t &component)
+{
+  const char *TAG = "GitHubMultiOTA::install";
+
+  char url[RELEASE_URL_SIZE];
+  snprintf(url, sizeof(url), "https://api.github.com/repos/%s/%s/releases/assets/%lu",
+           component.repo.owner, component.repo.repo, (unsigned long)component.asset_id);
+
+  // The GraphQL result carries no digest, the asset record does
+  uint8_t digest[SHA256_DIGEST_SIZE];
+  const uint8_t *sha256 = fetch_digest(url, digest) ? digest : nullptr;
+  if (!sha256)
+  {
+    ESP_LOGW(TAG, "%s/%s %s: no digest, the image is not verified\n",
+             component.repo.owner, component.repo.repo, component.repo.tag);
+  }
+
+  bool ok = component.sink
+                ? download_update(*_transport, url, sha256, *component.sink, &_control, _token)
+                : download_update(*_transport, url, sha256, component.command, &_control, _token);
+
+  ESP_LOGI(TAG, "%s/%s %s: %s\n", component.repo.owner, component.repo.repo, component.repo.tag,
+           ok ? "HTTP_UPDATE_OK" : "HTTP_UPDATE_FAILED");
+  return ok;
+}
+
+void GitHubMultiOTA::on_progress(void *ctx, size_t current, size_t total, const update_stats_t &stats)
+{
+  static_cast<GitHubMultiOTA *>(ctx)->notify(OTA_EVENT_PROGRESS, current, total, &stats);
+}
+
+void GitHubMultiOTA::notify(ota_event_type_t type, uint32_t current, uint32_t total, const update_stats_t *stats)
+{
+  ota_event_t event = {type, current, total,
+                       stats ? stats->bytes_per_sec : 0,
+                       stats ? stats->throttled_ms : 0};
+  _notifier.notify(event);
+}
@@ -0,0 +1,90 @@
+#ifndef ESP_GITHUBMULTI_OTA_H
+#define ESP_GITHUBMULTI_OTA_H
+
+#ifdef ESP8266
+#include <ESP8266WiFi.h>
+#elif defined(ESP32)
+#include <WiFiClientSecure.h>
+#endif
+
+#include "semver.h"
+#include "common.h"
+#include "transport.h"
+#include "trust_store.h"
+#include "release_url.h"
+#include "events.h"
+#include "sink.h"
+#include "sha256.h"
+
+#ifndef GITHUBOTA_MULTI_MAX
+#define GITHUBOTA_MULTI_MAX 4
+#endif
+
+struct ota_component_t
+{
+  // Owner and repository, the tag of the latest release after a check
+  release_ref_t repo;
+  semver_t version;
+  String asset_name;
+  // U_FLASH, U_FILESYSTEM or -1 for a sink
+  int command;
+  OtaSink *sink;
+  uint32_t asset_id;
+  uint32_t size;
+  bool changed;
+};
+
+// Updater for several independently released components, each in its own
+// repository. One GraphQL request over one connection resolves the latest
+// release of all of them, the response is parsed one component at a time,
+// and only components whose version changed are downloaded; the firmware
+// last, as it restarts the device. Images are verified against the SHA-256
+// digest of their asset record. The GraphQL API needs a token.
+class GitHubMultiOTA
+{
+public:
+  GitHubMultiOTA(const String &token);
+
+  // `repo` is "owner/name" or a repository URL, `version` the running one.
+  // Returns the index of the component or -1.
+  int add(const String &repo, const String &version, const String &asset_name, int command = U_FLASH);
+  // Component the library cannot write itself, e.g. the image of an attached
+  // MCU or a file on SD card
+  int add(const String &repo, const String &version, const String &asset_name, OtaSink &sink);
+  const ota_component_t &component(size_t index) const { return _components[index]; }
+
+  void handle();
+  // Checks at most every `seconds`, handle() returns right away in between.
+  // 0, the default, checks on every call.
+  void set_check_interval(uint32_t seconds);
+
+  void set_transport(OtaTransport &transport);
+  OtaTransport &transport();
+  void on_event(ota_event_cb_t callback, void *ctx = nullptr);
+  void set_progress_interval(uint8_t percent, uint32_t interval_ms);
+
+private:
+  int add_component(const String &repo, const String &version, const String &asset_name);
+  bool check();
+  String query();
+  void prepare_clock();
+  bool fetch_digest(const char *url, uint8_t sha256[SHA256_DIGEST_SIZE]);
+  bool install(ota_component_t &component);
+  void notify(ota_event_type_t type, uint32_t current = 0, uint32_t total = 0, const update_stats_t *stats = nullptr);
+  static void on_progress(void *ctx, size_t current, size_t total, const update_stats_t &stats);
+
+  String _token;
+  WiFiSecureTransport _default_transport;
+  OtaTransport *_transport;
+  update_control_t _control;
+  OtaNotifier _notifier;
+  ota_component_t _components[GITHUBOTA_MULTI_MAX];
+  size_t _count;
+  uint32_t _check_interval_ms;
+  unsigned long _last_check;
+  bool _checked;
+  // Unix time of the last NTP synchronization
+  uint32_t _last_ntp;
+};
+
+#endif
@@ -1,18 +1,21 @@
 #ifdef ESP8266
 #include <ESP8266WiFi.h>
-#include <ESP8266HTTPClient.h>
-#include <ESP8266httpUpdate.h>
+#include <Updater.h>
 #elif defined(ESP32)
 #include <WiFiClientSecure.h>
 #include <Update.h>
-#include <HTTPClient.h>
-#include <HTTPUpdate.h>
 #endif
 
+#include <sys/time.h>
 #include <ArduinoJson.h>
 #include "semver_extensions.h"
 #include "GitHubOTA.h"
 #include "common.h"
+#include "release_url.h"
+
+#define OTA_EVENT_QUEUE_LENGTH 8
+// Slots progress events leave free for the event that ends the check
+#define OTA_EVENT_QUEUE_RESERVED 1
 
 GitHubOTA::GitHubOTA(
     String version,
@@ -27,64 +30,700 @@ GitHubOTA::GitHubOTA(
   _release_url = release_url;
   _firmware_name = firmware_name;
   _fetch_url_via_redirect = fetch_url_via_redirect;
-
-  Updater.rebootOnUpdate(false);
-#ifdef ESP8266
-  _x509.append(github_certificate);
-  _wifi_client.setTrustAnchors(&_x509);
-#elif defined(ESP32)
-  _wifi_client.setCACert(github_certificate);
+  _transport = &_default_transport;
+  _peer = nullptr;
+  _catalog = nullptr;
+  _local_fs = nullptr;
+  _channel = OTA_CHANNEL_STABLE;
+  _prefetch = false;
+  // Loaded on first use, NVS is not ready while global objects are constructed
+  _staged_loaded = false;
+  _staged_valid = false;
+  _control = {false, false, 0, false, false, 1, nullptr, on_progress, this};
+  _arena = nullptr;
+  _arena_auto = false;
+  _rtc_cache = false;
+  _check_interval = 0;
+  memset(&_rtc, 0, sizeof(_rtc));
+#ifdef ESP32
+  _task = nullptr;
+  _task_done = nullptr;
+  _events = nullptr;
+  _task_interval = 0;
+  _task_stop = false;
 #endif
+}
 
-#ifdef LED_BUILTIN
-  Updater.setLedPin(LED_BUILTIN, LOW);
-#endif
-  Updater.onStart(update_started);
-  Updater.onEnd(update_finished);
-  Updater.onProgress(update_progress);
-  Updater.onError(update_error);
-  Updater.setFollowRedirects(HTTPC_FORCE_FOLLOW_REDIRECTS);
+void GitHubOTA::set_transport(OtaTransport &transport)
+{
+  _transport = &transport;
+}
+
+OtaTransport &GitHubOTA::transport()
+{
+  return *_transport;
 }
 
 void GitHubOTA::handle()
 {
   const char *TAG = "handle";
-  synchronize_system_time();
+  if (_rtc_cache && !check_due())
+  {
+    ESP_LOGV(TAG, "Next check due in %u s\n", _rtc.next_due - estimated_time());
+    return;
+  }
 
-  String base_url = _fetch_url_via_redirect ?
-    get_updated_base_url_via_redirect(_wifi_client, _release_url) :
-    get_updated_base_url_via_api(_wifi_client, _release_url);
-  ESP_LOGI(TAG, "base_url %s\n", base_url.c_str());
+  // A cancel() from here on, the check phase included, stops this update
+  _control.cancelled = false;
+  // Features enabled after enable_arena() count as well
+  if (_arena && _arena_auto)
+    _arena->resize(arena_size_for(_catalog != nullptr, _control.streams));
+  ArenaScope arena(_arena);
+  notify(OTA_EVENT_CHECKING);
+  // A local source needs neither internet access nor the clock for TLS
+  bool local = _local_manifest.length() > 0;
+  if (!local)
+    prepare_clock();
+
+  release_asset_t asset;
+  asset.size = 0;
+  asset.has_digest = false;
+  release_ref_t release;
+  bool found;
+  if (local)
+  {
+    found = local_manifest_load(_local_fs, *_transport, _local_manifest, release, asset);
+  }
+  else if (_catalog)
+  {
+    found = select_release(release, asset);
+    // The catalog keeps its own ETag, only the check schedule goes to RTC memory
+    if (_rtc_cache)
+      remember_release("", {"", false});
+  }
+  else
+  {
+    conditional_t conditional = {_rtc_cache ? String(_rtc.etag) : String(""), false};
+    String base_url = lookup_release(asset, _rtc_cache ? &conditional : nullptr);
+    found = parse_release_url(base_url.c_str(), release);
+
+    // A 304 carries none of the asset details (size, digest, label) an install
+    // is checked against, so a release that is still to be installed is fetched
+    // again in full
+    if (found && conditional.not_modified)
+    {
+      semver_t cached = from_string(tag_version(release.tag));
+      bool newer = update_required(cached, _version);
+      release_version(cached);
+      if (newer)
+      {
+        ESP_LOGI(TAG, "Release %s not installed yet, fetching its assets\n", release.tag);
+        conditional = {"", false};
+        base_url = lookup_release(asset, &conditional);
+        found = parse_release_url(base_url.c_str(), release);
+      }
+    }
+    ESP_LOGI(TAG, "base_url %s\n", base_url.c_str());
+  }
+  auto _new_version = from_string(found ? tag_version(release.tag) : "0.0.0");
+
+  // A pinned release is installed even when it is older
+  bool required = update_required(_new_version, _version);
+  if (_catalog && _catalog->pinned()[0])
+    required = found && semver_compare(_new_version, _version) != 0;
 
-  auto last_slash = base_url.lastIndexOf('/', base_url.length() - 2);
-  auto semver_str = base_url.substring(last_slash + 1);
-  auto _new_version = from_string(semver_str.c_str());
+  if (required && !preflight_check(asset, U_FLASH, _rejection))
+  {
+    ESP_LOGE(TAG, "Update to %s rejected: %s\n", release.tag, _rejection.c_str());
+    release_version(_new_version);
+    // Check the full release again next time, a 304 would skip the asset details
+    if (_rtc_cache)
+    {
+      _rtc.etag[0] = '\0';
+      save_rtc_state();
+    }
+    notify(OTA_EVENT_REJECTED);
+    return;
+  }
 
-  if (update_required(_new_version, _version))
+  // A prefetched release only needs to be activated, apply() restarts unless
+  // the staged image is damaged, which is then downloaded again
+  bool staged = required && staged_ready() && strcmp(_staged.tag, release.tag) == 0;
+  if (staged && _prefetch)
   {
-    auto result = update_firmware(base_url + _firmware_name);
+    ESP_LOGI(TAG, "Release %s is already staged\n", release.tag);
+    release_version(_new_version);
+    notify(OTA_EVENT_STAGED);
+    return;
+  }
+  if (staged)
+    apply();
+
+  if (required && _control.cancelled)
+  {
+    ESP_LOGI(TAG, "Cancelled before the download\n");
+    release_version(_new_version);
+    notify(OTA_EVENT_CANCELLED);
+    return;
+  }
 
-    if (result != HTTP_UPDATE_OK)
+  if (required)
+  {
+    notify(OTA_EVENT_STARTED);
+
+    // The download overwrites whatever was staged
+    if (staged_ready())
+    {
+      staged_clear();
+      _staged_valid = false;
+    }
+
+    bool updated = !local && update_firmware_from_peer(_new_version, asset);
+    release_version(_new_version);
+    if (!updated && !_control.cancelled)
+      updated = update_firmware(release, asset);
+
+    if (!updated)
+    {
+      ESP_LOGI(TAG, "Update failed\n");
+      // Fetch the full release again next time, the cached ETag would skip the asset details
+      if (_rtc_cache)
+      {
+        _rtc.etag[0] = '\0';
+        save_rtc_state();
+      }
+      notify(_control.cancelled ? OTA_EVENT_CANCELLED : OTA_EVENT_FAILED);
+      return;
+    }
+
+    if (_prefetch)
     {
-      ESP_LOGI(TAG, "Update failed: %s\n", Updater.getLastErrorString().c_str());
+      notify(stage_release(release, asset) ? OTA_EVENT_STAGED : OTA_EVENT_FAILED);
       return;
     }
 
     ESP_LOGI(TAG, "Update successful. Restarting...\n");
+    notify(OTA_EVENT_FINISHED);
     delay(1000);
     ESP.restart();
   }
 
+  release_version(_new_version);
   ESP_LOGI(TAG, "No updates found\n");
+  ESP_LOGI(TAG, "Connections opened: %u, reused: %u\n",
+           _transport->connections_opened(), _transport->connections_reused());
+  notify(OTA_EVENT_NO_UPDATE);
+}
+
+bool GitHubOTA::prefetch()
+{
+  // The image size for hashing the staged image comes from the release metadata
+  if (_fetch_url_via_redirect)
+  {
+    ESP_LOGE("prefetch", "Staging needs the API mode\n");
+    return false;
+  }
+
+  _prefetch = true;
+  handle();
+  _prefetch = false;
+  return staged_ready();
+}
+
+bool GitHubOTA::apply()
+{
+  const char *TAG = "apply";
+  if (!staged_ready())
+  {
+    ESP_LOGI(TAG, "Nothing staged\n");
+    return false;
+  }
+
+  bool ok = staged_activate(_staged);
+  staged_clear();
+  _staged_valid = false;
+  if (!ok)
+    return false;
+
+  ESP_LOGI(TAG, "Activated %s. Restarting...\n", _staged.tag);
+  notify(OTA_EVENT_FINISHED);
+  delay(1000);
+  ESP.restart();
+  return true;
+}
+
+const char *GitHubOTA::staged()
+{
+  return staged_ready() ? _staged.tag : "";
+}
+
+bool GitHubOTA::staged_ready()
+{
+  if (!_staged_loaded)
+  {
+    _staged_valid = staged_load(_staged);
+    _staged_loaded = true;
+  }
+  return _staged_valid;
 }
 
-HTTPUpdateResult GitHubOTA::update_firmware(String url)
+// Keeps the image that was just written from being activated and remembers it
+bool GitHubOTA::stage_release(const release_ref_t &release, const release_asset_t &asset)
+{
+  const char *TAG = "stage_release";
+
+  memset(&_staged, 0, sizeof(_staged));
+  strncpy(_staged.tag, release.tag, sizeof(_staged.tag) - 1);
+  _staged.size = asset.size;
+  _staged_valid = _staged.size > 0 && staged_hold(_staged) && staged_save(_staged);
+  _staged_loaded = true;
+  ESP_LOGI(TAG, "Release %s %s\n", release.tag, _staged_valid ? "staged" : "could not be staged");
+  return _staged_valid;
+}
+
+// Refreshes the catalog and picks the pinned release or the newest one of the channel
+bool GitHubOTA::select_release(release_ref_t &release, release_asset_t &asset)
+{
+  const char *TAG = "select_release";
+  if (!parse_repo_url(_release_url.c_str(), release))
+  {
+    ESP_LOGE(TAG, "Not a repository URL: %s\n", _release_url.c_str());
+    return false;
+  }
+
+  if (!_catalog->refresh(*_transport, release, _token))
+  {
+    ESP_LOGI(TAG, "Using the stored catalog\n");
+  }
+
+  const char *pinned = _catalog->pinned();
+  const catalog_entry_t *entry = pinned[0] ? _catalog->find(pinned) : _catalog->latest(_channel);
+  if (!entry)
+  {
+    ESP_LOGI(TAG, "No release %s in the catalog\n", pinned);
+    return false;
+  }
+  _catalog->to_asset(*entry, release, asset);
+  ESP_LOGI(TAG, "Release %s\n", release.tag);
+  return true;
+}
+
+bool GitHubOTA::update_firmware(const release_ref_t &release, const release_asset_t &asset)
 {
   const char *TAG = "update_firmware";
-  ESP_LOGI(TAG, "Download URL: %s\n", url.c_str());
+  char url[RELEASE_URL_SIZE];
+  const uint8_t *sha256 = asset.has_digest ? asset.sha256 : nullptr;
+
+  bool ok;
+  if (_local_manifest.length())
+  {
+    ok = local_update(_local_fs, *_transport, asset, U_FLASH, &_control);
+  }
+  else if (_token.length() == 0)
+  {
+    ok = build_download_url(release, _firmware_name.c_str(), url, sizeof(url)) &&
+         download_update(*_transport, url, sha256, U_FLASH, &_control);
+  }
+  else if (asset.url.length() == 0)
+  {
+    ESP_LOGE(TAG, "No asset %s in the release\n", _firmware_name.c_str());
+    ok = false;
+  }
+  else
+  {
+    ok = download_update(*_transport, asset.url, sha256, U_FLASH, &_control, _token);
+  }
+  ESP_LOGI(TAG, "%s\n", ok ? "HTTP_UPDATE_OK" : "HTTP_UPDATE_FAILED");
+  return ok;
+}
+
+bool GitHubOTA::update_firmware_from_peer(semver_t version, const release_asset_t &asset)
+{
+  const char *TAG = "update_firmware_from_peer";
+  if (!_peer || _fetch_url_via_redirect)
+    return false;
+
+  IPAddress peer_ip;
+  if (!_peer->discover(version, _firmware_name, peer_ip))
+    return false;
+
+  if (!_peer->download(*_transport, peer_ip, asset, &_control))
+  {
+    ESP_LOGI(TAG, "Peer update failed, falling back to GitHub\n");
+    return false;
+  }
+  return true;
+}
+
+void GitHubOTA::set_local_source(fs::FS &fs, const String &manifest_path)
+{
+  _local_fs = &fs;
+  _local_manifest = manifest_path;
+}
 
-  auto result = Updater.update(_wifi_client, url);
+void GitHubOTA::set_local_source(const String &manifest_url)
+{
+  _local_fs = nullptr;
+  _local_manifest = manifest_url;
+}
+
+void GitHubOTA::set_token(const String &token)
+{
+  _token = token;
+}
 
-  print_update_result(Updater, result, TAG);
-  return result;
+#ifdef ESP32
+bool GitHubOTA::load_token()
+{
+  return token_load(_token);
 }
+#endif
+
+void GitHubOTA::enable_catalog(fs::FS &fs, const char *path)
+{
+  const char *TAG = "enable_catalog";
+  if (_catalog)
+    return;
+  if (_fetch_url_via_redirect)
+  {
+    ESP_LOGE(TAG, "The release catalog needs the API mode\n");
+    return;
+  }
+
+  _catalog = new ReleaseCatalog(fs, path, _firmware_name);
+  _catalog->load();
+}
+
+void GitHubOTA::set_channel(ota_channel_t channel)
+{
+  _channel = channel;
+}
+
+void GitHubOTA::pin_version(const String &tag)
+{
+  if (_catalog)
+    _catalog->pin(tag.c_str());
+}
+
+bool GitHubOTA::rollback()
+{
+  const char *TAG = "rollback";
+  if (!_catalog)
+    return false;
+
+  semver_key_t current;
+  semver_key(_version, current);
+  const catalog_entry_t *entry = _catalog->previous(current, to_string(_version).c_str());
+  if (!entry)
+  {
+    ESP_LOGI(TAG, "No older release in the catalog\n");
+    return false;
+  }
+  ESP_LOGI(TAG, "Rolling back to %s\n", entry->tag);
+  _catalog->pin(entry->tag);
+  return true;
+}
+
+void GitHubOTA::mark_good()
+{
+  if (!_catalog)
+    return;
+
+  semver_key_t current;
+  semver_key(_version, current);
+  _catalog->mark_good(current, to_string(_version).c_str());
+}
+
+void GitHubOTA::enable_peer_mode(uint16_t port)
+{
+#ifdef ESP8266
+  // No ESP8266 peer could serve an image matching the published digest, see peer.h
+  ESP_LOGE("enable_peer_mode", "Peer mode is not supported on ESP8266\n");
+  return;
+#endif
+  if (_peer)
+    return;
+
+  _peer = new OtaPeer(port);
+  _peer->begin(_version, _firmware_name);
+}
+
+void GitHubOTA::handle_peers()
+{
+  if (_peer)
+    _peer->handle();
+}
+
+void GitHubOTA::enable_arena(size_t size, bool reserve)
+{
+  if (_arena)
+    return;
+
+  _arena_auto = size == 0;
+  _arena = new OtaArena(_arena_auto ? arena_size_for(_catalog != nullptr, _control.streams) : size, reserve);
+}
+
+void GitHubOTA::enable_rtc_cache(uint32_t check_interval_s)
+{
+  const char *TAG = "enable_rtc_cache";
+
+  _rtc_cache = true;
+  _check_interval = check_interval_s;
+  if (!rtc_load(_rtc))
+  {
+    ESP_LOGI(TAG, "No valid RTC state, next check is due\n");
+    return;
+  }
+
+#ifdef ESP8266
+  if (_transport == &_default_transport)
+    memcpy((void *)&_default_transport.session(), _rtc.session, sizeof(BearSSL::Session));
+#endif
+}
+
+// Decided from RTC memory and millis() only, without radio or flash access
+bool GitHubOTA::check_due()
+{
+  uint32_t now = estimated_time();
+  return now == 0 || now >= _rtc.next_due;
+}
+
+void GitHubOTA::prepare_sleep(uint64_t sleep_us)
+{
+  if (!_rtc_cache)
+    return;
+
+  uint32_t now = estimated_time();
+  if (now == 0)
+    return;
+
+  _rtc.clock_at_boot = now + sleep_us / 1000000;
+  _rtc.sleep_armed = 1;
+  save_rtc_state();
+}
+
+// Unix time from the system clock, or carried across deep sleep; 0 if unknown
+uint32_t GitHubOTA::estimated_time()
+{
+  time_t now = time(nullptr);
+  if (now > 8 * 3600 * 2)
+    return now;
+  if (_rtc_cache && _rtc.sleep_armed)
+    return _rtc.clock_at_boot + millis() / 1000;
+  return 0;
+}
+
+// Certificate validation only needs a rough clock, NTP is skipped while the
+// carried clock is recent enough
+void GitHubOTA::prepare_clock()
+{
+  uint32_t now = estimated_time();
+  if (!_rtc_cache || now == 0 || now - _rtc.last_ntp > GITHUBOTA_NTP_INTERVAL_S)
+  {
+    synchronize_system_time();
+    _rtc.last_ntp = time(nullptr);
+    return;
+  }
+
+  if (time(nullptr) < (time_t)now)
+  {
+    timeval tv = {(time_t)now, 0};
+    settimeofday(&tv, nullptr);
+  }
+}
+
+String GitHubOTA::lookup_release(release_asset_t &asset, conditional_t *conditional)
+{
+  String base_url = _fetch_url_via_redirect ?
+    get_updated_base_url_via_redirect(*_transport, _release_url) :
+    get_updated_base_url_via_api(*_transport, _release_url, _firmware_name, &asset, conditional, _token);
+  return _rtc_cache ? remember_release(base_url, *conditional) : base_url;
+}
+
+String GitHubOTA::remember_release(String base_url, const conditional_t &conditional)
+{
+  release_ref_t release;
+  if (conditional.not_modified)
+  {
+    char url[RELEASE_URL_SIZE];
+    bool known = _rtc.tag[0] && parse_repo_url(_release_url.c_str(), release);
+    if (known)
+      strcpy(release.tag, _rtc.tag);
+    base_url = known && build_download_url(release, "", url, sizeof(url)) ? url : "";
+  }
+  else if (parse_release_url(base_url.c_str(), release))
+  {
+    strcpy(_rtc.tag, release.tag);
+    bool fits = conditional.etag.length() < sizeof(_rtc.etag);
+    strncpy(_rtc.etag, fits ? conditional.etag.c_str() : "", sizeof(_rtc.etag));
+  }
+
+  // The carried clock is only valid across a sleep armed by prepare_sleep()
+  _rtc.next_due = time(nullptr) + _check_interval;
+  _rtc.clock_at_boot = time(nullptr) - millis() / 1000;
+  _rtc.sleep_armed = 0;
+  save_rtc_state();
+  return base_url;
+}
+
+void GitHubOTA::save_rtc_state()
+{
+#ifdef ESP8266
+  if (_transport == &_default_transport)
+    memcpy(_rtc.session, (const void *)&_default_transport.session(), sizeof(BearSSL::Session));
+#endif
+  rtc_save(_rtc);
+}
+
+void GitHubOTA::pause()
+{
+  _control.paused = true;
+}
+
+void GitHubOTA::resume()
+{
+  _control.paused = false;
+}
+
+void GitHubOTA::cancel()
+{
+  _control.cancelled = true;
+}
+
+void GitHubOTA::set_rate_limit(uint32_t bytes_per_sec)
+{
+  _control.rate_limit = bytes_per_sec;
+}
+
+void GitHubOTA::set_idle_only(bool idle_only)
+{
+  _control.idle_only = idle_only;
+}
+
+void GitHubOTA::set_busy(bool busy)
+{
+  _control.busy = busy;
+}
+
+#ifdef ESP32
+void GitHubOTA::set_parallel_streams(uint8_t streams)
+{
+  _control.streams = std::max(streams, (uint8_t)1);
+}
+#endif
+
+void GitHubOTA::on_progress(void *ctx, size_t current, size_t total, const update_stats_t &stats)
+{
+  static_cast<GitHubOTA *>(ctx)->notify(OTA_EVENT_PROGRESS, current, total, &stats);
+}
+
+void GitHubOTA::on_event(ota_event_cb_t callback, void *ctx)
+{
+  _notifier.set_callback(callback, ctx);
+}
+
+void GitHubOTA::set_progress_interval(uint8_t percent, uint32_t interval_ms)
+{
+  _notifier.set_progress_interval(percent, interval_ms);
+}
+
+void GitHubOTA::notify(ota_event_type_t type, uint32_t current, uint32_t total, const update_stats_t *stats)
+{
+  ota_event_t event = {type, current, total,
+                       stats ? stats->bytes_per_sec : 0,
+                       stats ? stats->throttled_ms : 0};
+  if (!_notifier.notify(event))
+    return;
+
+#ifdef ESP32
+  if (!_events)
+    return;
+
+  // Progress is best-effort, a slow consumer must not stall the download nor
+  // miss how it ended
+  if (type == OTA_EVENT_PROGRESS)
+  {
+    if (uxQueueSpacesAvailable(_events) > OTA_EVENT_QUEUE_RESERVED)
+      xQueueSend(_events, &event, 0);
+    return;
+  }
+  // Still full, the consumer left earlier events unread; the oldest goes
+  if (xQueueSend(_events, &event, 0) != pdTRUE)
+  {
+    ota_event_t oldest;
+    xQueueReceive(_events, &oldest, 0);
+    xQueueSend(_events, &event, 0);
+  }
+#endif
+}
+
+#ifdef ESP32
+bool GitHubOTA::begin_task(uint32_t interval_ms, BaseType_t core, uint32_t stack_size, UBaseType_t priority)
+{
+  const char *TAG = "begin_task";
+  // A task that ended itself from within is waited for here
+  if (_task && _task_stop)
+  {
+    xSemaphoreTake(_task_done, portMAX_DELAY);
+    _task = nullptr;
+  }
+  if (_task)
+    return true;
+
+  if (!_events)
+    _events = xQueueCreate(OTA_EVENT_QUEUE_LENGTH, sizeof(ota_event_t));
+  if (!_events)
+    return false;
+  if (!_task_done)
+    _task_done = xSemaphoreCreateBinary();
+  if (!_task_done)
+    return false;
+
+  _task_interval = interval_ms;
+  _task_stop = false;
+  if (xTaskCreatePinnedToCore(task_loop, "GitHubOTA", stack_size, this, priority, &_task, core) != pdPASS)
+  {
+    ESP_LOGE(TAG, "Unable to create update task\n");
+    _task = nullptr;
+    return false;
+  }
+  return true;
+}
+
+// The task finishes the current step and exits on its own, so no TLS session
+// or half-written partition is left behind. Waits for it to be gone, so a
+// following begin_task() never runs a second task on this instance.
+void GitHubOTA::end_task()
+{
+  if (!_task)
+    return;
+
+  _task_stop = true;
+  cancel();
+  // Called from the task itself (e.g. an event callback) it exits once
+  // handle() returns
+  if (xTaskGetCurrentTaskHandle() == _task)
+    return;
+
+  xTaskNotifyGive(_task);
+  xSemaphoreTake(_task_done, portMAX_DELAY);
+  _task = nullptr;
+}
+
+QueueHandle_t GitHubOTA::events()
+{
+  return _events;
+}
+
+void GitHubOTA::task_loop(void *arg)
+{
+  auto self = static_cast<GitHubOTA *>(arg);
+  while (!self->_task_stop)
+  {
+    self->handle();
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(self->_task_interval));
+  }
+  xSemaphoreGive(self->_task_done);
+  vTaskDelete(nullptr);
+}
+#endif
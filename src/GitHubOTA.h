@@ -3,13 +3,28 @@
 
 #ifdef ESP8266
 #include <ESP8266WiFi.h>
-#include <ESP8266httpUpdate.h>
 #elif defined(ESP32)
 #include <WiFiClientSecure.h>
-#include <HTTPUpdate.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
 #endif
 
 #include "semver.h"
+#include "peer.h"
+#include "common.h"
+#include "transport.h"
+#include "trust_store.h"
+#include "rtc_cache.h"
+#include "arena.h"
+#include "token_store.h"
+#include "release_url.h"
+#include "preflight.h"
+#include "catalog.h"
+#include "staging.h"
+#include "events.h"
+#include "local_source.h"
 
 class GitHubOTA
 {
@@ -22,22 +37,157 @@ public:
 
   void handle();
 
-private:
-#ifdef ESP8266
-  ESP8266HTTPUpdate Updater;
-#elif defined(ESP32)
-  HTTPUpdate Updater;
+  // Two-phase update: prefetch() runs the check like handle() but leaves a new
+  // release verified in the inactive partition instead of restarting, apply()
+  // activates it and restarts at a time of the application's choosing. The
+  // staged release is remembered (see staging.h), so it is not downloaded
+  // again and handle() activates it without a download. Needs the API mode.
+  bool prefetch();
+  bool apply();
+  // Tag of the staged release, empty if there is none
+  const char *staged();
+
+  // Route all traffic through another link (Ethernet, cellular, ...).
+  // The transport must outlive the updater.
+  void set_transport(OtaTransport &transport);
+  // Connection pool settings and opened/reused counters
+  OtaTransport &transport();
+
+  // Events of this updater (see events.h); progress is rate limited, by
+  // default to every GITHUBOTA_PROGRESS_PERCENT or GITHUBOTA_PROGRESS_INTERVAL_MS
+  void on_event(ota_event_cb_t callback, void *ctx = nullptr);
+  void set_progress_interval(uint8_t percent, uint32_t interval_ms);
+
+  // Why the last release was rejected by the pre-flight checks (see preflight.h)
+  const String &rejection() const { return _rejection; }
+
+  // Private repositories: release lookups are authenticated and the firmware is
+  // fetched through the asset API, which also raises the API rate limit from 60
+  // to 5000 requests per hour. Needs the API mode.
+  void set_token(const String &token);
+#ifdef ESP32
+  // Uses the token provisioned with token_save()
+  bool load_token();
 #endif
 
-  HTTPUpdateResult update_firmware(String url);
+  // Keep the last releases in a catalog on the filesystem (see catalog.h): a
+  // check refreshes it with one conditional request and picks the release from
+  // it, so switching channel, pinning or rolling back needs no extra API call.
+  // Needs the API mode and a mounted filesystem.
+  void enable_catalog(fs::FS &fs, const char *path = GITHUBOTA_CATALOG_PATH);
+  void set_channel(ota_channel_t channel);
+  // Installs exactly this tag on the next check, older ones included; an empty
+  // tag follows the channel again. Kept in the catalog across restarts.
+  void pin_version(const String &tag);
+  // Pins the newest known-good release older than the running one
+  bool rollback();
+  // Confirms the running version once it proved itself, as a rollback target
+  void mark_good();
+
+  // Install from a local source instead of GitHub (see local_source.h): a
+  // manifest on a mounted filesystem or on a plain HTTP server. The version
+  // comparison, pre-flight and digest checks, staging and events are the same,
+  // but no internet access, NTP or TLS is needed. An empty location switches
+  // back to GitHub.
+  void set_local_source(fs::FS &fs, const String &manifest_path);
+  void set_local_source(const String &manifest_url);
+
+  // Opt-in LAN distribution: serve the running image to neighbours and try them
+  // before GitHub. Needs the API mode, as only the API publishes asset digests.
+  // ESP32 only, see peer.h.
+  void enable_peer_mode(uint16_t port = GITHUBOTA_PEER_PORT);
+  void handle_peers();
+
+  // Pausing keeps the connection and the data written so far; keep pauses short,
+  // the server drops idle connections after a while. A pause before the download
+  // starts holds it until resume()
+  void pause();
+  void resume();
+  void cancel();
+
+  // Airtime budgeting for the download: cap in bytes/s (0 = unlimited) and an
+  // idle-only mode that holds the transfer back while set_busy(true) is in effect
+  void set_rate_limit(uint32_t bytes_per_sec);
+  void set_idle_only(bool idle_only);
+  void set_busy(bool busy);
+
+#ifdef ESP32
+  // Fetch large images over up to 4 concurrent Range connections (bounded by
+  // GITHUBOTA_POOL_SIZE), 1 for a single stream. Not used while throttled.
+  void set_parallel_streams(uint8_t streams);
+#endif
+
+  // Serve the allocations of each check from one arena, reserved now or
+  // borrowed from the heap only while a check runs, so long uptimes do not
+  // fragment the heap until the TLS handshake fails. A size of 0 fits the
+  // arena to the enabled features (catalog, parallel streams) at every check.
+  void enable_arena(size_t size = GITHUBOTA_ARENA_SIZE, bool reserve = true);
+
+  // Deep sleep support: the release check state is kept in RTC memory, so a wake
+  // cycle before the next check is due returns from handle() without touching
+  // the radio, and a due check skips NTP and resumes the TLS session for a
+  // single conditional request
+  void enable_rtc_cache(uint32_t check_interval_s);
+  bool check_due();
+  // Call right before entering deep sleep to carry the clock across it
+  void prepare_sleep(uint64_t sleep_us);
+
+#ifdef ESP32
+  // Runs handle() every interval_ms in its own task, reporting through events()
+  bool begin_task(uint32_t interval_ms, BaseType_t core = 0, uint32_t stack_size = 8192, UBaseType_t priority = 1);
+  void end_task();
+  QueueHandle_t events();
+#endif
+
+private:
+  bool update_firmware(const release_ref_t &release, const release_asset_t &asset);
+  bool update_firmware_from_peer(semver_t version, const release_asset_t &asset);
+  bool staged_ready();
+  bool stage_release(const release_ref_t &release, const release_asset_t &asset);
+  bool select_release(release_ref_t &release, release_asset_t &asset);
+  void notify(ota_event_type_t type, uint32_t current = 0, uint32_t total = 0, const update_stats_t *stats = nullptr);
+  static void on_progress(void *ctx, size_t current, size_t total, const update_stats_t &stats);
+  uint32_t estimated_time();
+  void prepare_clock();
+  String lookup_release(release_asset_t &asset, conditional_t *conditional);
+  String remember_release(String base_url, const conditional_t &conditional);
+  void save_rtc_state();
+#ifdef ESP32
+  static void task_loop(void *arg);
+#endif
 
   semver_t _version;
   String _release_url;
   String _firmware_name;
   bool _fetch_url_via_redirect;
-  WiFiClientSecure _wifi_client;
-#ifdef ESP8266
-  X509List _x509;
+  String _token;
+  String _rejection;
+  fs::FS *_local_fs;
+  String _local_manifest;
+  bool _prefetch;
+  bool _staged_loaded;
+  bool _staged_valid;
+  staged_image_t _staged;
+  WiFiSecureTransport _default_transport;
+  OtaTransport *_transport;
+  OtaPeer *_peer;
+  ReleaseCatalog *_catalog;
+  ota_channel_t _channel;
+  update_control_t _control;
+  OtaNotifier _notifier;
+  OtaArena *_arena;
+  // Sized from the enabled features at every check
+  bool _arena_auto;
+  bool _rtc_cache;
+  uint32_t _check_interval;
+  rtc_state_t _rtc;
+#ifdef ESP32
+  TaskHandle_t _task;
+  // Given by the task right before it deletes itself
+  SemaphoreHandle_t _task_done;
+  QueueHandle_t _events;
+  uint32_t _task_interval;
+  volatile bool _task_stop;
 #endif
 };
 
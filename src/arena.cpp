@@ -0,0 +1,238 @@
+#include <Arduino.h>
+#include "common.h"
+#include "arena.h"
+
+// Every block is preceded by its size and the offset of the block before it,
+// which also keeps blocks 8 byte aligned
+#define ARENA_ALIGN 8
+#define ARENA_HEADER ARENA_ALIGN
+// Set in the size of a block that was freed while blocks above it were in use
+#define ARENA_FREED 0x80000000u
+
+struct arena_header_t
+{
+  uint32_t size;
+  uint32_t previous;
+};
+static_assert(sizeof(arena_header_t) <= ARENA_HEADER, "arena header does not fit");
+
+#ifdef ESP8266
+// A single thread of execution
+#define ARENA_THREAD_LOCAL
+#else
+#define ARENA_THREAD_LOCAL thread_local
+#endif
+
+static ARENA_THREAD_LOCAL OtaArena *active_arena = nullptr;
+
+#ifdef ESP32
+// begin() may race between the loop task and a background check
+static portMUX_TYPE arena_lock = portMUX_INITIALIZER_UNLOCKED;
+#define ARENA_LOCK() portENTER_CRITICAL(&arena_lock)
+#define ARENA_UNLOCK() portEXIT_CRITICAL(&arena_lock)
+#else
+#define ARENA_LOCK()
+#define ARENA_UNLOCK()
+#endif
+
+static size_t align_up(size_t size)
+{
+  return (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+OtaArena::OtaArena(size_t size, bool reserve)
+{
+  _size = align_up(size);
+  _reserve = reserve;
+  _buffer = reserve ? (uint8_t *)malloc(_size) : nullptr;
+  _used = 0;
+  _last = 0;
+  _peak = 0;
+  _in_use = false;
+  _overflows = 0;
+}
+
+OtaArena::~OtaArena()
+{
+  if (active_arena == this)
+    active_arena = nullptr;
+  free(_buffer);
+}
+
+OtaArena *OtaArena::active()
+{
+  return active_arena;
+}
+
+size_t OtaArena::footprint(size_t size)
+{
+  return ARENA_HEADER + align_up(size);
+}
+
+bool OtaArena::begin()
+{
+  const char *TAG = "OtaArena::begin";
+
+  ARENA_LOCK();
+  bool busy = _in_use;
+  _in_use = true;
+  ARENA_UNLOCK();
+  if (busy)
+  {
+    ESP_LOGW(TAG, "Arena in use by another check, using the heap\n");
+    return false;
+  }
+
+  if (!_buffer)
+    _buffer = (uint8_t *)malloc(_size);
+  if (!_buffer)
+  {
+    ESP_LOGE(TAG, "Could not get %u bytes, using the heap\n", _size);
+    _in_use = false;
+    return false;
+  }
+
+  _used = 0;
+  _last = 0;
+  _peak = 0;
+  _overflows = 0;
+  active_arena = this;
+  return true;
+}
+
+void OtaArena::end()
+{
+  const char *TAG = "OtaArena::end";
+
+  ESP_LOGI(TAG, "Peak %u of %u bytes, %u overflows\n", _peak, _size, _overflows);
+  if (active_arena == this)
+    active_arena = nullptr;
+  _used = 0;
+  _last = 0;
+  if (!_reserve)
+  {
+    free(_buffer);
+    _buffer = nullptr;
+  }
+  _in_use = false;
+}
+
+bool OtaArena::resize(size_t size)
+{
+  size = align_up(size);
+  if (size == _size)
+    return true;
+  if (_in_use)
+    return false;
+
+  free(_buffer);
+  _size = size;
+  _buffer = _reserve ? (uint8_t *)malloc(_size) : nullptr;
+  return !_reserve || _buffer;
+}
+
+bool OtaArena::owns(const void *ptr) const
+{
+  return _buffer && ptr >= _buffer && ptr < _buffer + _size;
+}
+
+// Falls back to the heap when the arena is full, counting it so the arena size
+// can be tuned from the log
+void *OtaArena::allocate(size_t size)
+{
+  size_t needed = footprint(size);
+  if (!_buffer || needed > _size - _used)
+  {
+    _overflows++;
+    return malloc(size);
+  }
+
+  uint8_t *block = _buffer + _used;
+  auto header = (arena_header_t *)block;
+  header->size = size;
+  header->previous = _last;
+  _last = _used;
+  _used += needed;
+  _peak = std::max(_peak, _used);
+  return block + ARENA_HEADER;
+}
+
+void *OtaArena::reallocate(void *ptr, size_t size)
+{
+  if (!ptr)
+    return allocate(size);
+  if (!owns(ptr))
+    return realloc(ptr, size);
+
+  uint8_t *block = (uint8_t *)ptr - ARENA_HEADER;
+  auto header = (arena_header_t *)block;
+  size_t old_size = header->size & ~ARENA_FREED;
+
+  // The most recent block grows and shrinks in place
+  size_t needed = footprint(size);
+  if (block == _buffer + _last && _used > _last && needed <= _size - _last)
+  {
+    header->size = size;
+    _used = _last + needed;
+    _peak = std::max(_peak, _used);
+    return ptr;
+  }
+
+  void *moved = allocate(size);
+  if (moved)
+  {
+    memcpy(moved, ptr, std::min(old_size, size));
+    deallocate(ptr);
+  }
+  return moved;
+}
+
+// Blocks are given back in stack order: freeing the most recent block also
+// reclaims the blocks below it that were freed before, anything still in use
+// underneath waits for end()
+void OtaArena::deallocate(void *ptr)
+{
+  if (!ptr)
+    return;
+  if (!owns(ptr))
+  {
+    free(ptr);
+    return;
+  }
+
+  auto header = (arena_header_t *)((uint8_t *)ptr - ARENA_HEADER);
+  if ((uint8_t *)header != _buffer + _last || _used <= _last)
+  {
+    header->size |= ARENA_FREED;
+    return;
+  }
+
+  do
+  {
+    header = (arena_header_t *)(_buffer + _last);
+    _used = _last;
+    _last = header->previous;
+  } while (_used > 0 && (((arena_header_t *)(_buffer + _last))->size & ARENA_FREED));
+}
+
+void *ota_malloc(size_t size)
+{
+  OtaArena *arena = OtaArena::active();
+  return arena ? arena->allocate(size) : malloc(size);
+}
+
+void *ota_realloc(void *ptr, size_t size)
+{
+  OtaArena *arena = OtaArena::active();
+  return arena ? arena->reallocate(ptr, size) : realloc(ptr, size);
+}
+
+// Blocks from the arena must not outlive the check they were allocated in
+void ota_free(void *ptr)
+{
+  OtaArena *arena = OtaArena::active();
+  if (arena)
+    arena->deallocate(ptr);
+  else
+    free(ptr);
+}
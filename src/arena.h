@@ -0,0 +1,95 @@
+#ifndef GITHUBOTA_ARENA_H
+#define GITHUBOTA_ARENA_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// 0 sizes the arena from the features enabled when a check starts, see
+// arena_size_for() in common.h
+#ifndef GITHUBOTA_ARENA_SIZE
+#define GITHUBOTA_ARENA_SIZE 0
+#endif
+
+// Bump allocator serving the allocations of one update check, which are all
+// released in one step when the check ends instead of fragmenting the heap.
+// The block is either reserved for the lifetime of the arena or borrowed from
+// the heap only while a check runs.
+//
+// The active arena belongs to the task (ESP32) or thread (host) that called
+// begin(), allocations of other tasks keep going to the heap. An arena serves
+// one check at a time; a second begin() before end() fails and that check
+// uses the heap.
+//
+// Only raw blocks come from the arena: JSON documents, header lines, version
+// strings and sector buffers. String objects (URLs, tags, headers) still
+// allocate from the heap.
+class OtaArena
+{
+public:
+  OtaArena(size_t size, bool reserve = true);
+  ~OtaArena();
+
+  // Makes this the active arena of the calling task for ota_malloc() and friends
+  bool begin();
+  // Releases everything allocated since begin()
+  void end();
+  // Changes the size outside of a check, reserving the new block if reserved
+  bool resize(size_t size);
+
+  void *allocate(size_t size);
+  void *reallocate(void *ptr, size_t size);
+  void deallocate(void *ptr);
+  bool owns(const void *ptr) const;
+
+  size_t size() const { return _size; }
+  size_t peak() const { return _peak; }
+  // Allocations that did not fit and were served from the heap instead
+  uint32_t overflows() const { return _overflows; }
+
+  // Active arena of the calling task, if any
+  static OtaArena *active();
+  // Arena bytes taken by an allocation of `size` bytes
+  static size_t footprint(size_t size);
+
+private:
+  uint8_t *_buffer;
+  size_t _size;
+  size_t _used;
+  size_t _last;
+  size_t _peak;
+  bool _reserve;
+  bool _in_use;
+  uint32_t _overflows;
+};
+
+// Keeps an arena active for the duration of a scope, a null arena is a no-op
+class ArenaScope
+{
+public:
+  ArenaScope(OtaArena *arena) : _arena(arena && arena->begin() ? arena : nullptr) {}
+  ~ArenaScope()
+  {
+    if (_arena)
+      _arena->end();
+  }
+
+private:
+  OtaArena *_arena;
+};
+
+// Allocations on the update path: from the active arena if there is one,
+// otherwise from the heap
+void *ota_malloc(size_t size);
+void *ota_realloc(void *ptr, size_t size);
+void ota_free(void *ptr);
+
+struct ArenaJsonAllocator
+{
+  void *allocate(size_t size) { return ota_malloc(size); }
+  void deallocate(void *ptr) { ota_free(ptr); }
+  void *reallocate(void *ptr, size_t size) { return ota_realloc(ptr, size); }
+};
+
+typedef BasicJsonDocument<ArenaJsonAllocator> OtaJsonDocument;
+
+#endif
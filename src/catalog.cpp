@@ -0,0 +1,444 @@
+#ifdef ESP8266
+#include <ESP8266HTTPClient.h>
+#elif defined(ESP32)
+#include <HTTPClient.h>
+#endif
+#include <FS.h>
+#include <ArduinoJson.h>
+
+#include "catalog.h"
+#include "http.h"
+#include "arena.h"
+#include "rtc_cache.h"
+
+#define CATALOG_MAGIC 0x47484341 // "GHCA"
+#define CATALOG_FORMAT 2
+
+struct catalog_header_t
+{
+  uint32_t magic;
+  uint32_t crc;
+  uint16_t format;
+  uint16_t count;
+  char etag[CATALOG_ETAG_SIZE];
+  char pinned[RELEASE_TAG_SIZE];
+};
+
+static uint32_t catalog_crc(const catalog_header_t &header, const catalog_entry_t *entries)
+{
+  const uint8_t *fields = (const uint8_t *)&header + offsetof(catalog_header_t, format);
+  uint32_t crc = ota_crc32(fields, sizeof(catalog_header_t) - offsetof(catalog_header_t, format));
+  return ota_crc32((const uint8_t *)entries, header.count * sizeof(catalog_entry_t), crc);
+}
+
+ReleaseCatalog::ReleaseCatalog(fs::FS &fs, const char *path, const String &asset_name) : _fs(fs)
+{
+  _path = path;
+  _asset_name = asset_name;
+  _etag[0] = '\0';
+  _pinned[0] = '\0';
+  _count = 0;
+}
+
+bool ReleaseCatalog::load()
+{
+  const char *TAG = "ReleaseCatalog::load";
+
+  _etag[0] = '\0';
+  _pinned[0] = '\0';
+  _count = 0;
+  File file = _fs.open(_path, "r");
+  if (!file)
+    return false;
+
+  catalog_header_t header;
+  bool ok = file.read((uint8_t *)&header, sizeof(header)) == sizeof(header) &&
+            header.magic == CATALOG_MAGIC && header.format == CATALOG_FORMAT &&
+            header.count <= GITHUBOTA_CATALOG_SIZE;
+  size_t len = ok ? header.count * sizeof(catalog_entry_t) : 0;
+  ok = ok && (size_t)file.read((uint8_t *)_entries, len) == len && header.crc == catalog_crc(header, _entries);
+  file.close();
+
+  if (!ok)
+  {
+    ESP_LOGW(TAG, "%s is damaged, starting over\n", _path.c_str());
+    return false;
+  }
+  memcpy(_etag, header.etag, sizeof(_etag));
+  _etag[sizeof(_etag) - 1] = '\0';
+  memcpy(_pinned, header.pinned, sizeof(_pinned));
+  _pinned[sizeof(_pinned) - 1] = '\0';
+  _count = header.count;
+  ESP_LOGV(TAG, "%u releases\n", _count);
+  return true;
+}
+
+bool ReleaseCatalog::save()
+{
+  const char *TAG = "ReleaseCatalog::save";
+
+  catalog_header_t header;
+  memset(&header, 0, sizeof(header));
+  header.magic = CATALOG_MAGIC;
+  header.format = CATALOG_FORMAT;
+  header.count = _count;
+  strncpy(header.etag, _etag, sizeof(header.etag) - 1);
+  strncpy(header.pinned, _pinned, sizeof(header.pinned) - 1);
+  header.crc = catalog_crc(header, _entries);
+
+  String tmp_path = _path + ".tmp";
+  File file = _fs.open(tmp_path, "w");
+  if (!file)
+  {
+    ESP_LOGE(TAG, "Unable to create %s\n", tmp_path.c_str());
+    return false;
+  }
+  size_t len = _count * sizeof(catalog_entry_t);
+  bool ok = file.write((const uint8_t *)&header, sizeof(header)) == sizeof(header) &&
+            file.write((const uint8_t *)_entries, len) == len;
+  file.close();
+
+  // A power cut leaves either the previous or the new catalog behind
+  if (!ok || !_fs.rename(tmp_path, _path))
+  {
+    ESP_LOGE(TAG, "Unable to write %s\n", _path.c_str());
+    _fs.remove(tmp_path);
+    return false;
+  }
+  return true;
+}
+
+// Lowest version among the published releases of the listing, with or
+// without the asset
+static void keep_oldest(const char *tag, semver_key_t &oldest_key, char *oldest)
+{
+  semver_key_t key;
+  semver_t version = from_string(tag_version(tag));
+  semver_key(version, key);
+  release_version(version);
+  if (!oldest[0] || semver_key_compare(key, tag_version(tag), oldest_key, tag_version(oldest)) < 0)
+  {
+    oldest_key = key;
+    strcpy(oldest, tag);
+  }
+}
+
+// Next character that is not white space, 0 on timeout
+static char next_token(Stream &stream)
+{
+  char c;
+  while (stream.readBytes(&c, 1) == 1)
+  {
+    if (!isspace((unsigned char)c))
+      return c;
+  }
+  return 0;
+}
+
+// Scalar value of the next `key` ("\"name\":") in the current object
+static bool read_value(Stream &stream, const char *key, JsonDocument &value)
+{
+  return stream.find(key) && deserializeJson(value, stream) == DeserializationError::Ok;
+}
+
+// Skips the rest of the object the stream is in up to its closing '}',
+// braces inside strings aside
+static bool skip_object(Stream &stream)
+{
+  int depth = 1;
+  bool in_string = false, escaped = false;
+  char c;
+  while (depth > 0 && stream.readBytes(&c, 1) == 1)
+  {
+    if (escaped)
+      escaped = false;
+    else if (in_string && c == '\\')
+      escaped = true;
+    else if (c == '"')
+      in_string = !in_string;
+    else if (!in_string && c == '{')
+      depth++;
+    else if (!in_string && c == '}')
+      depth--;
+  }
+  return depth == 0;
+}
+
+bool ReleaseCatalog::refresh(OtaTransport &transport, const release_ref_t &repo, const String &token)
+{
+  const char *TAG = "ReleaseCatalog::refresh";
+
+  char url[RELEASE_URL_SIZE];
+  snprintf(url, sizeof(url), "https://api.github.com/repos/%s/%s/releases?per_page=%u",
+           repo.owner, repo.repo, GITHUBOTA_CATALOG_SIZE);
+
+  OtaHttp https(transport);
+  github_authorize(https, token, false);
+  if (_etag[0])
+    https.add_header("If-None-Match", _etag);
+
+  int httpCode = https.get(url);
+  if (httpCode == HTTP_CODE_NOT_MODIFIED)
+  {
+    ESP_LOGI(TAG, "Release list not modified\n");
+    https.end();
+    return true;
+  }
+  if (httpCode != HTTP_CODE_OK)
+  {
+    ESP_LOGI(TAG, "[HTTPS] GET... failed, httpCode: %d\n", httpCode);
+    https.end();
+    return false;
+  }
+
+  auto fresh = (catalog_entry_t *)ota_malloc(CATALOG_MERGE_SIZE);
+  if (!fresh)
+  {
+    ESP_LOGE(TAG, "Out of memory\n");
+    https.end();
+    return false;
+  }
+
+  // One release at a time and in it one asset at a time, neither the list nor
+  // a release with many assets would fit into memory
+  size_t count = 0, listed = 0;
+  semver_key_t oldest_key;
+  char oldest[RELEASE_TAG_SIZE] = "";
+  bool ok = https.stream().find('[');
+  char next = ok ? next_token(https.stream()) : 0;
+  while (ok && next == '{' && listed < GITHUBOTA_CATALOG_SIZE)
+  {
+    bool published, matched;
+    ok = read_release(https.stream(), fresh[count], published, matched);
+    if (!ok)
+      break;
+    listed++;
+    if (published)
+      keep_oldest(fresh[count].tag, oldest_key, oldest);
+    if (matched)
+      count++;
+
+    next = next_token(https.stream());
+    if (next == ',')
+      next = next_token(https.stream());
+  }
+  // The list ends at ']', or at a full page
+  ok = ok && (next == ']' || (next == '{' && listed == GITHUBOTA_CATALOG_SIZE));
+  if (!ok)
+  {
+    ESP_LOGI(TAG, "Malformed release list after %u releases\n", listed);
+  }
+  if (ok)
+    _etag[0] = '\0';
+  if (ok && https.etag().length() < sizeof(_etag))
+    strncpy(_etag, https.etag().c_str(), sizeof(_etag));
+  https.end();
+
+  if (ok)
+  {
+    // A short page is the whole list, a full one ends at its oldest release
+    merge(fresh, count, listed < GITHUBOTA_CATALOG_SIZE ? nullptr : oldest, fresh + GITHUBOTA_CATALOG_SIZE);
+    ok = save();
+    ESP_LOGI(TAG, "%u releases listed, %u in the catalog\n", count, _count);
+  }
+  ota_free(fresh);
+  return ok;
+}
+
+// Reads one release of the list, its '{' already taken, up to its closing
+// '}'. GitHub lists tag, draft and prerelease flags before the assets; these
+// are parsed one at a time into a small document, like in read_release() of
+// common.cpp. `published` is set for releases that are not drafts, `matched`
+// when they carry the updater's asset, which is then filled into `entry`.
+bool ReleaseCatalog::read_release(Stream &stream, catalog_entry_t &entry, bool &published, bool &matched)
+{
+  const char *TAG = "ReleaseCatalog::read_release";
+
+  memset(&entry, 0, sizeof(entry));
+  published = false;
+  matched = false;
+
+  StaticJsonDocument<RELEASE_TAG_SIZE + 64> value;
+  if (!read_value(stream, "\"tag_name\":", value))
+  {
+    ESP_LOGI(TAG, "No tag_name\n");
+    return false;
+  }
+  const char *tag = value.as<const char *>();
+  bool valid = tag && strlen(tag) < sizeof(entry.tag);
+  if (valid)
+    strncpy(entry.tag, tag, sizeof(entry.tag) - 1);
+
+  if (!read_value(stream, "\"draft\":", value))
+    return false;
+  published = valid && !value.as<bool>();
+  if (!read_value(stream, "\"prerelease\":", value))
+    return false;
+  if (value.as<bool>())
+    entry.flags |= CATALOG_PRERELEASE;
+
+  if (!stream.find("\"assets\":["))
+    return false;
+
+  StaticJsonDocument<128> filter;
+  filter["name"] = true;
+  filter["id"] = true;
+  filter["size"] = true;
+  filter["label"] = true;
+  filter["digest"] = true;
+
+  do
+  {
+    OtaJsonDocument item(RELEASE_ASSET_JSON_SIZE);
+    auto result = deserializeJson(item, stream, DeserializationOption::Filter(filter));
+    if (result != DeserializationError::Ok)
+    {
+      // An empty list ends right at ']'
+      if (result == DeserializationError::InvalidInput)
+        break;
+      ESP_LOGI(TAG, "deserializeJson error %s\n", result.c_str());
+      return false;
+    }
+    if (!published || matched || _asset_name != (const char *)item["name"])
+      continue;
+
+    matched = true;
+    strncpy(entry.label, item["label"] | "", sizeof(entry.label) - 1);
+    entry.asset_id = item["id"];
+    entry.size = item["size"];
+    if (parse_sha256_digest(item["digest"], entry.sha256))
+      entry.flags |= CATALOG_HAS_DIGEST;
+  } while (stream.findUntil(",", "]"));
+
+  if (matched)
+  {
+    semver_t version = from_string(tag_version(entry.tag));
+    semver_key(version, entry.key);
+    release_version(version);
+  }
+  return skip_object(stream);
+}
+
+// Listed releases replace the known ones with the same tag. Of the unlisted
+// ones only those below `oldest`, which fell off the end of the list, are kept
+// while they rank among the newest; newer ones were deleted or lost their
+// asset. Without `oldest` the list was complete and none are kept.
+void ReleaseCatalog::merge(catalog_entry_t *fresh, size_t count, const char *oldest, catalog_entry_t *merged)
+{
+  const size_t total = GITHUBOTA_CATALOG_SIZE * 2;
+  const catalog_entry_t *all[total];
+  semver_key_t keys[total];
+  const char *versions[total];
+  uint16_t order[total];
+
+  size_t n = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    // Confirmation by the application survives the refresh
+    const catalog_entry_t *known = find(fresh[i].tag);
+    if (known)
+      fresh[i].flags |= known->flags & CATALOG_KNOWN_GOOD;
+    all[n++] = &fresh[i];
+  }
+  semver_key_t oldest_key;
+  if (oldest)
+  {
+    semver_t version = from_string(tag_version(oldest));
+    semver_key(version, oldest_key);
+    release_version(version);
+  }
+  for (size_t i = 0; i < _count && oldest; i++)
+  {
+    bool listed = false;
+    for (size_t j = 0; j < count && !listed; j++)
+      listed = strcmp(_entries[i].tag, fresh[j].tag) == 0;
+    if (!listed && semver_key_compare(_entries[i].key, tag_version(_entries[i].tag),
+                                      oldest_key, tag_version(oldest)) < 0)
+      all[n++] = &_entries[i];
+  }
+
+  for (size_t i = 0; i < n; i++)
+  {
+    keys[i] = all[i]->key;
+    versions[i] = tag_version(all[i]->tag);
+  }
+  semver_key_rank(keys, order, n, versions);
+
+  _count = std::min(n, (size_t)GITHUBOTA_CATALOG_SIZE);
+  for (size_t i = 0; i < _count; i++)
+    merged[i] = *all[order[i]];
+  memcpy(_entries, merged, _count * sizeof(catalog_entry_t));
+}
+
+const catalog_entry_t *ReleaseCatalog::latest(ota_channel_t channel) const
+{
+  for (size_t i = 0; i < _count; i++)
+  {
+    if (channel == OTA_CHANNEL_PRERELEASE || !(_entries[i].flags & CATALOG_PRERELEASE))
+      return &_entries[i];
+  }
+  return nullptr;
+}
+
+const catalog_entry_t *ReleaseCatalog::find(const char *tag) const
+{
+  for (size_t i = 0; i < _count; i++)
+  {
+    if (strcmp(_entries[i].tag, tag) == 0)
+      return &_entries[i];
+  }
+  return nullptr;
+}
+
+const catalog_entry_t *ReleaseCatalog::previous(const semver_key_t &version, const char *version_string) const
+{
+  const catalog_entry_t *older = nullptr;
+  for (size_t i = 0; i < _count; i++)
+  {
+    if (semver_key_compare(_entries[i].key, tag_version(_entries[i].tag), version, version_string) >= 0)
+      continue;
+    if (_entries[i].flags & CATALOG_KNOWN_GOOD)
+      return &_entries[i];
+    if (!older)
+      older = &_entries[i];
+  }
+  return older;
+}
+
+void ReleaseCatalog::mark_good(const semver_key_t &version, const char *version_string)
+{
+  for (size_t i = 0; i < _count; i++)
+  {
+    if (semver_key_compare(_entries[i].key, tag_version(_entries[i].tag), version, version_string) == 0 && !(_entries[i].flags & CATALOG_KNOWN_GOOD))
+    {
+      _entries[i].flags |= CATALOG_KNOWN_GOOD;
+      save();
+      return;
+    }
+  }
+}
+
+void ReleaseCatalog::pin(const char *tag)
+{
+  if (strcmp(_pinned, tag) == 0)
+    return;
+
+  strncpy(_pinned, tag, sizeof(_pinned) - 1);
+  _pinned[sizeof(_pinned) - 1] = '\0';
+  save();
+}
+
+void ReleaseCatalog::to_asset(const catalog_entry_t &entry, release_ref_t &release, release_asset_t &asset) const
+{
+  char url[RELEASE_URL_SIZE];
+  snprintf(url, sizeof(url), "https://api.github.com/repos/%s/%s/releases/assets/%lu",
+           release.owner, release.repo, (unsigned long)entry.asset_id);
+
+  memcpy(release.tag, entry.tag, sizeof(release.tag));
+  asset.name = _asset_name;
+  asset.size = entry.size;
+  asset.url = url;
+  asset.label = entry.label;
+  asset.has_digest = entry.flags & CATALOG_HAS_DIGEST;
+  memcpy(asset.sha256, entry.sha256, SHA256_DIGEST_SIZE);
+}
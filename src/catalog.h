@@ -0,0 +1,95 @@
+#ifndef GITHUBOTA_CATALOG_H
+#define GITHUBOTA_CATALOG_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <ArduinoJson.h>
+
+#include "common.h"
+#include "release_url.h"
+#include "semver_extensions.h"
+
+#ifndef GITHUBOTA_CATALOG_PATH
+#define GITHUBOTA_CATALOG_PATH "/ota_catalog.bin"
+#endif
+// Releases kept in the catalog, the newest ones by version
+#ifndef GITHUBOTA_CATALOG_SIZE
+#define GITHUBOTA_CATALOG_SIZE 8
+#endif
+#define CATALOG_LABEL_SIZE 64
+#define CATALOG_ETAG_SIZE 64
+
+enum ota_channel_t
+{
+  OTA_CHANNEL_STABLE,
+  // Prereleases (as flagged on GitHub) are installed as well
+  OTA_CHANNEL_PRERELEASE
+};
+
+#define CATALOG_PRERELEASE 0x01
+#define CATALOG_HAS_DIGEST 0x02
+// The application confirmed this version with mark_good()
+#define CATALOG_KNOWN_GOOD 0x04
+
+// One release that carries the updater's asset
+struct catalog_entry_t
+{
+  semver_key_t key;
+  char tag[RELEASE_TAG_SIZE];
+  char label[CATALOG_LABEL_SIZE];
+  uint32_t asset_id;
+  uint32_t size;
+  uint8_t sha256[SHA256_DIGEST_SIZE];
+  uint8_t flags;
+};
+
+// Listed releases of a refresh followed by room for the merged catalog
+#define CATALOG_MERGE_SIZE (2 * GITHUBOTA_CATALOG_SIZE * sizeof(catalog_entry_t))
+
+// Compact index of the last releases on the filesystem, CRC protected and
+// replaced atomically. A refresh is one conditional request for the release
+// list, merged into what is already known; choosing a channel, pinning a tag
+// or rolling back is then decided locally and only the asset download needs
+// the network.
+class ReleaseCatalog
+{
+public:
+  ReleaseCatalog(fs::FS &fs, const char *path, const String &asset_name);
+
+  bool load();
+  bool save();
+  // Fetches the release list unless GitHub reports it unchanged (304). False
+  // on errors, the catalog then stays as it was.
+  bool refresh(OtaTransport &transport, const release_ref_t &repo, const String &token = "");
+
+  // Entries are ordered by version, highest first
+  size_t size() const { return _count; }
+  const catalog_entry_t &entry(size_t i) const { return _entries[i]; }
+
+  const catalog_entry_t *latest(ota_channel_t channel) const;
+  const catalog_entry_t *find(const char *tag) const;
+  // The newest known-good release below `version`, or the newest one below it
+  // when none was confirmed. `version_string` resolves truncated keys.
+  const catalog_entry_t *previous(const semver_key_t &version, const char *version_string) const;
+  void mark_good(const semver_key_t &version, const char *version_string);
+  // The pin is stored with the catalog, so a rollback outlives the restart
+  void pin(const char *tag);
+  const char *pinned() const { return _pinned; }
+
+  // Fills the tag of `release` and the asset details, with the asset API URL
+  void to_asset(const catalog_entry_t &entry, release_ref_t &release, release_asset_t &asset) const;
+
+private:
+  bool read_release(Stream &stream, catalog_entry_t &entry, bool &published, bool &matched);
+  void merge(catalog_entry_t *fresh, size_t count, const char *oldest, catalog_entry_t *merged);
+
+  fs::FS &_fs;
+  String _path;
+  String _asset_name;
+  char _etag[CATALOG_ETAG_SIZE];
+  char _pinned[RELEASE_TAG_SIZE];
+  catalog_entry_t _entries[GITHUBOTA_CATALOG_SIZE];
+  size_t _count;
+};
+
+#endif
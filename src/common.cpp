@@ -1,76 +1,150 @@
 #ifdef ESP8266
 #include <ESP8266WiFi.h>
 #include <ESP8266HTTPClient.h>
-#include <ESP8266httpUpdate.h>
+#include <Updater.h>
 #elif defined(ESP32)
 #include <WiFiClientSecure.h>
 #include <Update.h>
 #include <HTTPClient.h>
-#include <HTTPUpdate.h>
 #endif
 
 #include <ArduinoJson.h>
 #include "common.h"
+#include "http.h"
+#include "release_url.h"
+#include "arena.h"
+#include "catalog.h"
+#include "partition_writer.h"
+#include "parallel.h"
 #include "semver.h"
 #include "semver_extensions.h"
 
-String get_updated_base_url_via_api(WiFiClientSecure wifi_client, String release_url)
+// Download URL of the release that `release_url` points to, ending in '/'
+static String release_download_base(const char *release_url)
 {
-  const char *TAG = "get_updated_base_url_via_api";
-  ESP_LOGI(TAG, "Release_url: %s\n", release_url.c_str());
+  const char *TAG = "release_download_base";
 
-  HTTPClient https;
-  String base_url = "";
+  release_ref_t ref;
+  char url[RELEASE_URL_SIZE];
+  if (!parse_release_url(release_url, ref) || !build_download_url(ref, "", url, sizeof(url)))
+  {
+    ESP_LOGE(TAG, "Not a release URL: %s\n", release_url ? release_url : "");
+    return "";
+  }
+  return url;
+}
 
-#ifdef ESP8266
-  bool mfln = wifi_client.probeMaxFragmentLength("github.com", 443, 1024);
-  ESP_LOGI(TAG, "MFLN supported: %s\n", mfln ? "yes" : "no");
-  if (mfln) { wifi_client.setBufferSizes(1024, 1024); }
-#endif
+// Reads html_url and the asset named `asset_name` from the release object on
+// `stream`. GitHub lists html_url before the assets, which are parsed one at a
+// time, so memory does not grow with the number of assets in the release.
+static bool read_release(Stream &stream, const String &asset_name, String &html_url, release_asset_t *asset)
+{
+  const char *TAG = "read_release";
 
-  if (!https.begin(wifi_client, release_url))
+  // The first html_url is the release's, those of the author and the
+  // uploaders come later
+  StaticJsonDocument<256> url;
+  DeserializationError result = DeserializationError::InvalidInput;
+  if (stream.find("\"html_url\":"))
+    result = deserializeJson(url, stream);
+  if (result != DeserializationError::Ok || !url.is<const char *>())
   {
-    ESP_LOGI(TAG, "[HTTPS] Unable to connect\n");
-    return base_url;
+    ESP_LOGI(TAG, "No html_url: %s\n", result.c_str());
+    return false;
   }
+  html_url = url.as<const char *>();
+  if (!asset)
+    return true;
 
-  int httpCode = https.GET();
-  if (httpCode < 0 || httpCode >= 400)
+  asset->name = asset_name;
+  asset->size = 0;
+  asset->url = "";
+  asset->label = "";
+  asset->has_digest = false;
+  if (!stream.find("\"assets\":["))
   {
-    ESP_LOGI(TAG, "[HTTPS] GET... failed, error: %s\n", https.errorToString(httpCode).c_str());
-    char errorText[128];
-#ifdef ESP8266
-    int errCode = wifi_client.getLastSSLError(errorText, sizeof(errorText));
-#elif defined(ESP32)
-    int errCode = wifi_client.lastError(errorText, sizeof(errorText));
-#endif
-    ESP_LOGV(TAG, "httpCode: %d, errorCode %d: %s\n", httpCode, errCode, errorText);
+    ESP_LOGI(TAG, "No assets\n");
+    return true;
   }
-  else if (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_MOVED_PERMANENTLY)
-  {
-    StaticJsonDocument<64> filter;
-    filter["html_url"] = true;
 
-    StaticJsonDocument<256> doc;
-    auto result = deserializeJson(doc, https.getStream(), DeserializationOption::Filter(filter));
-    if (result != DeserializationError::Ok) {
+  StaticJsonDocument<128> filter;
+  filter["name"] = true;
+  filter["size"] = true;
+  filter["url"] = true;
+  filter["label"] = true;
+  filter["digest"] = true;
+
+  // An asset that does not fit fails the lookup, it could be the one searched for
+  do
+  {
+    OtaJsonDocument item(RELEASE_ASSET_JSON_SIZE);
+    result = deserializeJson(item, stream, DeserializationOption::Filter(filter));
+    if (result != DeserializationError::Ok)
+    {
+      // An empty list ends right at ']'
+      if (result == DeserializationError::InvalidInput)
+        return true;
       ESP_LOGI(TAG, "deserializeJson error %s\n", result.c_str());
+      return false;
     }
+    if (asset_name != (const char *)item["name"])
+      continue;
 
-    base_url = String((const char *)doc["html_url"]);
-    base_url.replace("tag", "download");
-    base_url += "/";
+    asset->size = item["size"];
+    asset->url = (const char *)item["url"];
+    asset->label = (const char *)item["label"];
+    asset->has_digest = parse_sha256_digest(item["digest"], asset->sha256);
+    ESP_LOGV(TAG, "asset %s: size %d, digest %s\n", asset_name.c_str(), asset->size, asset->has_digest ? "yes" : "no");
+    return true;
+  } while (stream.findUntil(",", "]"));
+  return true;
+}
+
+String get_updated_base_url_via_api(OtaTransport &transport, String release_url, String asset_name, release_asset_t *asset, conditional_t *conditional, const String &token)
+{
+  const char *TAG = "get_updated_base_url_via_api";
+  ESP_LOGI(TAG, "Release_url: %s\n", release_url.c_str());
+
+  OtaHttp https(transport);
+  String base_url = "";
+  github_authorize(https, token, false);
+
+  if (conditional)
+  {
+    conditional->not_modified = false;
+    if (conditional->etag.length() > 0)
+      https.add_header("If-None-Match", conditional->etag);
+  }
+
+  int httpCode = https.get(release_url);
+  if (httpCode == HTTP_CODE_NOT_MODIFIED && conditional)
+  {
+    ESP_LOGI(TAG, "Release not modified\n");
+    conditional->not_modified = true;
+  }
+  else if (httpCode < 0 || httpCode >= 400)
+  {
+    ESP_LOGI(TAG, "[HTTPS] GET... failed, httpCode: %d\n", httpCode);
+    ESP_LOGV(TAG, "transport error: %s\n", transport.last_error().c_str());
+  }
+  else if (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_MOVED_PERMANENTLY)
+  {
+    String html_url;
+    if (read_release(https.stream(), asset_name, html_url, asset))
+      base_url = release_download_base(html_url.c_str());
+    if (conditional && base_url.length() > 0)
+      conditional->etag = https.etag();
   }
 
   https.end();
   return base_url;
 }
 
-String get_updated_base_url_via_redirect(WiFiClientSecure wifi_client, String release_url)
+String get_updated_base_url_via_redirect(OtaTransport &transport, String release_url)
 {
   const char *TAG = "get_updated_base_url_via_redirect";
 
-  String location = get_redirect_location(wifi_client, release_url);
+  String location = get_redirect_location(transport, release_url);
   ESP_LOGV(TAG, "location: %s\n", location.c_str());
 
   if (location.length() <= 0)
@@ -79,91 +153,112 @@ String get_updated_base_url_via_redirect(WiFiClientSecure wifi_client, String re
     return "";
   }
 
-  String base_url = "";
-  base_url = location + "/";
-  base_url.replace("tag", "download");
+  String base_url = release_download_base(location.c_str());
 
   ESP_LOGV(TAG, "returns: %s\n", base_url.c_str());
   return base_url;
 }
 
-String get_redirect_location(WiFiClientSecure wifi_client, String initial_url)
+String get_redirect_location(OtaTransport &transport, String initial_url)
 {
   const char *TAG = "get_redirect_location";
   ESP_LOGV(TAG, "initial_url: %s\n", initial_url.c_str());
 
-  HTTPClient https;
-  https.setFollowRedirects(HTTPC_DISABLE_FOLLOW_REDIRECTS);
+  OtaHttp https(transport);
 
-#ifdef ESP8266
-  bool mfln = wifi_client.probeMaxFragmentLength("github.com", 443, 1024);
-  ESP_LOGI(TAG, "MFLN supported: %s\n", mfln ? "yes" : "no");
-  if (mfln) { wifi_client.setBufferSizes(1024, 1024); }
-#endif
-
-  if (!https.begin(wifi_client, initial_url))
-  {
-    ESP_LOGE(TAG, "[HTTPS] Unable to connect\n");
-    return "";
-  }
-
-  int httpCode = https.GET();
+  int httpCode = https.get(initial_url);
   if (httpCode != HTTP_CODE_FOUND)
   {
     ESP_LOGE(TAG, "[HTTPS] GET... failed, No redirect\n");
-    char errorText[128];
-#ifdef ESP8266
-    int errCode = wifi_client.getLastSSLError(errorText, sizeof(errorText));
-#elif defined(ESP32)
-    int errCode = wifi_client.lastError(errorText, sizeof(errorText));
-#endif
-    ESP_LOGV(TAG, "httpCode: %d, errorCode %d: %s\n", httpCode, errCode, errorText);
+    ESP_LOGV(TAG, "httpCode: %d, transport error: %s\n", httpCode, transport.last_error().c_str());
   }
 
-  String redirect_url = https.getLocation();
+  String redirect_url = https.location();
   https.end();
 
   ESP_LOGV(TAG, "returns: %s\n", redirect_url.c_str());
   return redirect_url;
 }
 
-void print_update_result(Updater updater, HTTPUpdateResult result, const char *TAG)
+bool update_from_stream(Stream &stream, size_t size, const uint8_t *sha256, int command, update_control_t *control)
 {
-  switch (result){
-    case HTTP_UPDATE_FAILED:
-      ESP_LOGI(TAG, "HTTP_UPDATE_FAILED Error (%d): %s\n", updater.getLastError(), updater.getLastErrorString().c_str());
-      break;
-    case HTTP_UPDATE_NO_UPDATES:
-      ESP_LOGI(TAG, "HTTP_UPDATE_NO_UPDATES\n");
-      break;
-    case HTTP_UPDATE_OK:
-      ESP_LOGI(TAG, "HTTP_UPDATE_OK\n");
-      break;
-  }
+  PartitionWriter writer(command, control ? control->partition : nullptr);
+  return update_from_stream(stream, size, sha256, writer, control);
 }
 
-bool update_required(semver_t _new_version, semver_t _current_version){
-  return _new_version > _current_version;
+// Downloads `url`, following redirects to the asset host, straight into flash
+// or into `sink` when given
+static bool download(OtaTransport &transport, String url, const uint8_t *sha256, int command, OtaSink *sink, update_control_t *control, const String &token)
+{
+  const char *TAG = "download_update";
+  ESP_LOGI(TAG, "Download URL: %s\n", url.c_str());
+
+  OtaHttp https(transport);
+  https.follow_redirects(true);
+  // The asset API answers with a redirect to a signed CDN URL, the token is
+  // only sent to the API host
+  github_authorize(https, token, true);
+
+  bool ok = false;
+  int httpCode = https.get(url);
+  if (httpCode != HTTP_CODE_OK)
+  {
+    ESP_LOGE(TAG, "[HTTPS] GET... failed, httpCode: %d\n", httpCode);
+  }
+  else if (https.size() <= 0)
+  {
+    ESP_LOGE(TAG, "[HTTPS] Missing Content-Length\n");
+  }
+  else if (sink)
+  {
+    ok = update_from_stream(https.stream(), https.size(), sha256, *sink, control);
+  }
+  else
+  {
+    bool fallback = true;
+#ifdef ESP32
+    // Throttled downloads are meant to be slow, they stay on a single stream
+    bool parallel = control && control->streams > 1 && !control->rate_limit && !control->idle_only &&
+                    https.size() >= PARALLEL_MIN_SIZE;
+    if (parallel)
+      ok = parallel_update(transport, https, sha256, command, control, fallback);
+#endif
+    if (fallback)
+      ok = update_from_stream(https.stream(), https.size(), sha256, command, control);
+  }
+
+  https.end();
+  ESP_LOGI(TAG, "Connections opened: %u, reused: %u\n",
+           transport.connections_opened(), transport.connections_reused());
+  return ok;
 }
 
-void update_started()
+bool download_update(OtaTransport &transport, String url, const uint8_t *sha256, int command, update_control_t *control, const String &token)
 {
-  ESP_LOGI("update_started", "HTTP update process started\n");
+  return download(transport, url, sha256, command, nullptr, control, token);
 }
 
-void update_finished()
+bool download_update(OtaTransport &transport, String url, const uint8_t *sha256, OtaSink &sink, update_control_t *control, const String &token)
 {
-  ESP_LOGI("update_finished", "HTTP update process finished\n");
+  return download(transport, url, sha256, -1, &sink, control, token);
 }
 
-void update_progress(int currentlyReceiced, int totalBytes)
-{
-  ESP_LOGI("update_progress", "Data received, Progress: %.2f %%\r", 100.0 * currentlyReceiced / totalBytes);
+bool update_required(semver_t _new_version, semver_t _current_version){
+  return _new_version > _current_version;
 }
 
-void update_error(int err)
+size_t arena_size_for(bool catalog, uint8_t streams)
 {
-  ESP_LOGI("update_error", "HTTP update fatal error code %d\n", err);
+  size_t line = OtaArena::footprint(HTTP_MAX_LINE);
+  size_t lookup = catalog ?
+    OtaArena::footprint(CATALOG_MERGE_SIZE) + OtaArena::footprint(RELEASE_ASSET_JSON_SIZE) :
+    OtaArena::footprint(RELEASE_ASSET_JSON_SIZE);
+  size_t download = OtaArena::footprint(PARTITION_SECTOR_SIZE);
+  if (streams > 1)
+    download += streams * OtaArena::footprint(PARTITION_SECTOR_SIZE);
+
+  // Prerelease strings of the versions compared along the way
+  return line + std::max(lookup, download) + 4 * OtaArena::footprint(32);
 }
 
 // Set time via NTP, as required for x.509 validation
@@ -180,28 +275,3 @@ void synchronize_system_time()
   struct tm timeinfo;
   gmtime_r(&now, &timeinfo);
 }
-
-const char *github_certificate PROGMEM = R"CERT(
------BEGIN CERTIFICATE-----
-MIIDrzCCApegAwIBAgIQCDvgVpBCRrGhdWrJWZHHSjANBgkqhkiG9w0BAQUFADBh
-MQswCQYDVQQGEwJVUzEVMBMGA1UEChMMRGlnaUNlcnQgSW5jMRkwFwYDVQQLExB3
-d3cuZGlnaWNlcnQuY29tMSAwHgYDVQQDExdEaWdpQ2VydCBHbG9iYWwgUm9vdCBD
-QTAeFw0wNjExMTAwMDAwMDBaFw0zMTExMTAwMDAwMDBaMGExCzAJBgNVBAYTAlVT
-MRUwEwYDVQQKEwxEaWdpQ2VydCBJbmMxGTAXBgNVBAsTEHd3dy5kaWdpY2VydC5j
-b20xIDAeBgNVBAMTF0RpZ2lDZXJ0IEdsb2JhbCBSb290IENBMIIBIjANBgkqhkiG
-9w0BAQEFAAOCAQ8AMIIBCgKCAQEA4jvhEXLeqKTTo1eqUKKPC3eQyaKl7hLOllsB
-CSDMAZOnTjC3U/dDxGkAV53ijSLdhwZAAIEJzs4bg7/fzTtxRuLWZscFs3YnFo97
-nh6Vfe63SKMI2tavegw5BmV/Sl0fvBf4q77uKNd0f3p4mVmFaG5cIzJLv07A6Fpt
-43C/dxC//AH2hdmoRBBYMql1GNXRor5H4idq9Joz+EkIYIvUX7Q6hL+hqkpMfT7P
-T19sdl6gSzeRntwi5m3OFBqOasv+zbMUZBfHWymeMr/y7vrTC0LUq7dBMtoM1O/4
-gdW7jVg/tRvoSSiicNoxBN33shbyTApOB6jtSj1etX+jkMOvJwIDAQABo2MwYTAO
-BgNVHQ8BAf8EBAMCAYYwDwYDVR0TAQH/BAUwAwEB/zAdBgNVHQ4EFgQUA95QNVbR
-TLtm8KPiGxvDl7I90VUwHwYDVR0jBBgwFoAUA95QNVbRTLtm8KPiGxvDl7I90VUw
-DQYJKoZIhvcNAQEFBQADggEBAMucN6pIExIK+t1EnE9SsPTfrgT1eXkIoyQY/Esr
-hMAtudXH/vTBH1jLuG2cenTnmCmrEbXjcKChzUyImZOMkXDiqw8cvpOp/2PV5Adg
-06O/nVsJ8dWO41P0jmP6P6fbtGbfYmbW0W5BjfIttep3Sp+dWOIrWcBAI+0tKIJF
-PnlUkiaY4IBIqDfv8NZ5YBberOgOzW6sRBc4L0na4UU+Krk2U886UAb3LujEV0ls
-YSEY1QSteDwsOoBrp+uvFRTp2InBuThs4pFsiv9kuXclVzDAGySj4dzp30d8tbQk
-CAUw7C29C79Fv1C5qfPrmAESrciIxpg0X40KPMbp1ZWVbd4=
------END CERTIFICATE-----
-)CERT";
\ No newline at end of file
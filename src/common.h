@@ -1,46 +1,112 @@
 #ifndef GITHUBOTA_COMMON_H
 #define GITHUBOTA_COMMON_H
 
+#include "log.h"
+
 #ifdef ESP8266
-#define ESP_LOGE(tag, ...) Serial.printf("[ %s ] ", tag); Serial.printf(__VA_ARGS__)
-#define ESP_LOGW(tag, ...) Serial.printf("[ %s ] ", tag); Serial.printf(__VA_ARGS__)
-#define ESP_LOGI(tag, ...) Serial.printf("[ %s ] ", tag); Serial.printf(__VA_ARGS__)
-#define ESP_LOGD(tag, ...) Serial.printf("[ %s ] ", tag); Serial.printf(__VA_ARGS__)
-#define ESP_LOGV(tag, ...) Serial.printf("[ %s ] ", tag); Serial.printf(__VA_ARGS__)
+#define ESP_LOGE(tag, ...) GITHUBOTA_LOG(GITHUBOTA_LOG_ERROR, tag, __VA_ARGS__)
+#define ESP_LOGW(tag, ...) GITHUBOTA_LOG(GITHUBOTA_LOG_WARN, tag, __VA_ARGS__)
+#define ESP_LOGI(tag, ...) GITHUBOTA_LOG(GITHUBOTA_LOG_INFO, tag, __VA_ARGS__)
+#define ESP_LOGD(tag, ...) GITHUBOTA_LOG(GITHUBOTA_LOG_DEBUG, tag, __VA_ARGS__)
+#define ESP_LOGV(tag, ...) GITHUBOTA_LOG(GITHUBOTA_LOG_VERBOSE, tag, __VA_ARGS__)
 #endif
 
 #ifdef ESP8266
 #include <ESP8266WiFi.h>
-#include <ESP8266httpUpdate.h>
+#include <Updater.h>
+#define U_FILESYSTEM U_FS
 #elif defined(ESP32)
 #include <WiFiClientSecure.h>
 #include <Update.h>
-#include <HTTPClient.h>
-#include <HTTPUpdate.h>
-#endif
-
-#ifdef ESP8266
-typedef ESP8266HTTPUpdate Updater;
-#elif defined(ESP32)
-typedef HTTPUpdate Updater;
+#define U_FILESYSTEM U_SPIFFS
 #endif
 
 #include "semver.h"
+#include "transport.h"
+#include "sha256.h"
+
+// Release asset metadata as published by the GitHub releases API
+struct release_asset_t
+{
+  String name;
+  int size;
+  // API URL of the asset, the only way to download assets of private repositories
+  String url;
+  // Device requirements declared in the asset's label, see preflight.h
+  String label;
+  bool has_digest;
+  uint8_t sha256[SHA256_DIGEST_SIZE];
+};
+
+// Conditional release lookup: with `etag` set the request carries If-None-Match
+// and a 304 (which GitHub does not count against the rate limit) is reported
+// through `not_modified`. `etag` is updated from every 200 response.
+struct conditional_t
+{
+  String etag;
+  bool not_modified;
+};
 
-String get_updated_base_url_via_api(WiFiClientSecure wifi_client, String release_url);
-String get_updated_base_url_via_redirect(WiFiClientSecure wifi_client, String release_url);
-String get_redirect_location(WiFiClientSecure wifi_client, String initial_url);
+// Document for one asset of the release lookup, filtered down to name, size,
+// url, label and digest
+#define RELEASE_ASSET_JSON_SIZE 768
 
-void print_update_result(Updater updater, HTTPUpdateResult result, const char *TAG);
+// `token` authenticates against the GitHub API, required for private repositories
+String get_updated_base_url_via_api(OtaTransport &transport, String release_url, String asset_name = "", release_asset_t *asset = nullptr, conditional_t *conditional = nullptr, const String &token = "");
+String get_updated_base_url_via_redirect(OtaTransport &transport, String release_url);
+String get_redirect_location(OtaTransport &transport, String initial_url);
+
+struct update_stats_t
+{
+  uint32_t elapsed_ms;
+  // Time spent held back by the rate limit or the idle-only mode
+  uint32_t throttled_ms;
+  uint32_t bytes_per_sec;
+  // Flash sectors programmed vs. left alone because their content was unchanged
+  uint32_t sectors_written;
+  uint32_t sectors_skipped;
+};
+
+// Cooperative control of a running download. The flags may be set from another
+// task; a paused download keeps its connection and written data and continues
+// where it stopped once resumed.
+struct update_control_t
+{
+  volatile bool paused;
+  volatile bool cancelled;
+  // Airtime budget: cap in bytes/s, 0 for unlimited. With idle_only the download
+  // also holds back for as long as the application reports being busy.
+  uint32_t rate_limit;
+  bool idle_only;
+  volatile bool busy;
+  // Concurrent Range connections for large downloads (ESP32), 1 for a single stream
+  uint8_t streams;
+  // Label of the data partition to write instead of the default one (ESP32),
+  // nullptr for the default
+  const char *partition;
+  void (*progress)(void *ctx, size_t current, size_t total, const update_stats_t &stats);
+  void *ctx;
+};
+
+class OtaSink;
+
+bool update_from_stream(Stream &stream, size_t size, const uint8_t *sha256, int command = U_FLASH, update_control_t *control = nullptr);
+bool update_from_stream(Stream &stream, size_t size, const uint8_t *sha256, OtaSink &sink, update_control_t *control = nullptr);
+// With `token` set, `url` is the API URL of a release asset (release_asset_t::url)
+bool download_update(OtaTransport &transport, String url, const uint8_t *sha256, int command = U_FLASH, update_control_t *control = nullptr, const String &token = "");
+// Streams the asset into `sink` (see sink.h) instead of one of the ESP's partitions
+bool download_update(OtaTransport &transport, String url, const uint8_t *sha256, OtaSink &sink, update_control_t *control = nullptr, const String &token = "");
 
 bool update_required(semver_t _new_version, semver_t _current_version);
 
+// Arena bytes a check takes (see arena.h): the release lookup, a header line and
+// an asset document or the catalog's merge buffer and one asset document,
+// then the download, a header line and the sector buffer of every stream
+size_t arena_size_for(bool catalog, uint8_t streams);
+
 void update_started();
 void update_finished();
-void update_progress(int currentlyReceiced, int totalBytes);
 void update_error(int err);
 void synchronize_system_time();
 
-extern const char *github_certificate;
-
 #endif
\ No newline at end of file
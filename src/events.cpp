@@ -0,0 +1,43 @@
+#include <Arduino.h>
+
+#include "events.h"
+
+OtaNotifier::OtaNotifier()
+{
+  _callback = nullptr;
+  _ctx = nullptr;
+  _percent = GITHUBOTA_PROGRESS_PERCENT;
+  _interval_ms = GITHUBOTA_PROGRESS_INTERVAL_MS;
+  _last_current = 0;
+  _last_ms = 0;
+}
+
+void OtaNotifier::set_callback(ota_event_cb_t callback, void *ctx)
+{
+  _callback = callback;
+  _ctx = ctx;
+}
+
+void OtaNotifier::set_progress_interval(uint8_t percent, uint32_t interval_ms)
+{
+  _percent = percent;
+  _interval_ms = interval_ms;
+}
+
+bool OtaNotifier::notify(const ota_event_t &event)
+{
+  if (event.type == OTA_EVENT_PROGRESS && event.current < event.total)
+  {
+    bool step = _percent && (uint64_t)(event.current - _last_current) * 100 >= (uint64_t)_percent * event.total;
+    bool interval = _interval_ms && millis() - _last_ms >= _interval_ms;
+    if ((_percent || _interval_ms) && !step && !interval)
+      return false;
+  }
+
+  // Every other event starts the progress of the next phase from scratch
+  _last_current = event.type == OTA_EVENT_PROGRESS ? event.current : 0;
+  _last_ms = millis();
+  if (_callback)
+    _callback(_ctx, event);
+  return true;
+}
@@ -0,0 +1,64 @@
+#ifndef GITHUBOTA_EVENTS_H
+#define GITHUBOTA_EVENTS_H
+
+#include <Arduino.h>
+
+// Progress is delivered after advancing this many percent or after this much
+// time, whichever comes first; 0 disables a criterion, both 0 every chunk
+#ifndef GITHUBOTA_PROGRESS_PERCENT
+#define GITHUBOTA_PROGRESS_PERCENT 1
+#endif
+#ifndef GITHUBOTA_PROGRESS_INTERVAL_MS
+#define GITHUBOTA_PROGRESS_INTERVAL_MS 500
+#endif
+
+enum ota_event_type_t
+{
+  OTA_EVENT_CHECKING,
+  OTA_EVENT_NO_UPDATE,
+  OTA_EVENT_STARTED,
+  OTA_EVENT_PROGRESS,
+  OTA_EVENT_FINISHED,
+  OTA_EVENT_FAILED,
+  OTA_EVENT_CANCELLED,
+  // The release does not fit or does not match this device, see rejection()
+  OTA_EVENT_REJECTED,
+  // prefetch() staged the release, apply() activates it
+  OTA_EVENT_STAGED
+};
+
+struct ota_event_t
+{
+  ota_event_type_t type;
+  uint32_t current;
+  uint32_t total;
+  uint32_t bytes_per_sec;
+  uint32_t throttled_ms;
+};
+
+// Called in the context of the task running the update, keep it short
+typedef void (*ota_event_cb_t)(void *ctx, const ota_event_t &event);
+
+// Per-updater event delivery with rate limited progress
+class OtaNotifier
+{
+public:
+  OtaNotifier();
+
+  void set_callback(ota_event_cb_t callback, void *ctx);
+  void set_progress_interval(uint8_t percent, uint32_t interval_ms);
+
+  // Hands the event to the callback, false for progress held back by the
+  // rate limit. Other events and the final progress always pass.
+  bool notify(const ota_event_t &event);
+
+private:
+  ota_event_cb_t _callback;
+  void *_ctx;
+  uint8_t _percent;
+  uint32_t _interval_ms;
+  uint32_t _last_current;
+  unsigned long _last_ms;
+};
+
+#endif
@@ -0,0 +1,210 @@
+#ifdef ESP8266
+#include <ESP8266HTTPClient.h>
+#elif defined(ESP32)
+#include <HTTPClient.h>
+#endif
+#include <FS.h>
+#include <vector>
+
+#include "file_sync.h"
+#include "http.h"
+#include "common.h"
+
+#define SYNC_BUFFER_SIZE 512
+
+bool parse_manifest_line(const String &line, manifest_entry_t &entry)
+{
+  int first = line.indexOf(' ');
+  int second = first < 0 ? -1 : line.indexOf(' ', first + 1);
+  int third = second < 0 ? -1 : line.indexOf(' ', second + 1);
+  if (third < 0)
+    return false;
+
+  if (!parse_hex_digest(line.substring(0, first).c_str(), entry.sha256))
+    return false;
+  entry.offset = strtoul(line.substring(first + 1, second).c_str(), nullptr, 10);
+  entry.size = strtoul(line.substring(second + 1, third).c_str(), nullptr, 10);
+  entry.path = line.substring(third + 1);
+  return entry.path.startsWith("/");
+}
+
+bool file_matches(fs::FS &fs, const manifest_entry_t &entry)
+{
+  if (!fs.exists(entry.path))
+    return false;
+
+  File file = fs.open(entry.path, "r");
+  if (!file || file.size() != entry.size)
+    return false;
+
+  Sha256 hash;
+  uint8_t buffer[SYNC_BUFFER_SIZE];
+  size_t len;
+  while ((len = file.read(buffer, sizeof(buffer))) > 0)
+    hash.update(buffer, len);
+  file.close();
+
+  uint8_t digest[SHA256_DIGEST_SIZE];
+  hash.finish(digest);
+  return memcmp(digest, entry.sha256, SHA256_DIGEST_SIZE) == 0;
+}
+
+static bool fetch_file(OtaTransport &transport, fs::FS &fs, String pack_url, const manifest_entry_t &entry, update_control_t *control, const String &token)
+{
+  const char *TAG = "fetch_file";
+
+  String tmp_path = entry.path + ".tmp";
+#ifdef ESP32
+  File file = fs.open(tmp_path, FILE_WRITE, true);
+#else
+  File file = fs.open(tmp_path, "w");
+#endif
+  if (!file)
+  {
+    ESP_LOGE(TAG, "Unable to create %s\n", tmp_path.c_str());
+    return false;
+  }
+
+  Sha256 hash;
+  size_t received = 0;
+  if (entry.size > 0)
+  {
+    OtaHttp https(transport);
+    https.follow_redirects(true);
+    github_authorize(https, token, true);
+    https.add_header("Range", "bytes=" + String(entry.offset) + "-" + String(entry.offset + entry.size - 1));
+
+    int httpCode = https.get(pack_url);
+    if (httpCode != HTTP_CODE_PARTIAL_CONTENT || https.size() != (int)entry.size)
+    {
+      ESP_LOGE(TAG, "[HTTPS] Range GET... failed, httpCode: %d, size: %d\n", httpCode, https.size());
+    }
+    else
+    {
+      uint8_t buffer[SYNC_BUFFER_SIZE];
+      while (received < entry.size && !(control && control->cancelled))
+      {
+        size_t len = https.stream().readBytes(buffer, std::min(sizeof(buffer), entry.size - received));
+        if (len == 0 || file.write(buffer, len) != len)
+          break;
+        hash.update(buffer, len);
+        received += len;
+      }
+    }
+    https.end();
+  }
+  file.close();
+
+  uint8_t digest[SHA256_DIGEST_SIZE];
+  hash.finish(digest);
+  if (received != entry.size || memcmp(digest, entry.sha256, SHA256_DIGEST_SIZE) != 0)
+  {
+    ESP_LOGE(TAG, "%s: incomplete or corrupted (%u of %u bytes)\n", entry.path.c_str(), received, entry.size);
+    fs.remove(tmp_path);
+    return false;
+  }
+
+  // LittleFS renames atomically, replacing the previous version of the file
+  if (!fs.rename(tmp_path, entry.path))
+  {
+    ESP_LOGE(TAG, "Unable to replace %s\n", entry.path.c_str());
+    fs.remove(tmp_path);
+    return false;
+  }
+  return true;
+}
+
+bool sync_files(OtaTransport &transport, fs::FS &fs, String manifest_url, String pack_url,
+                const uint8_t *manifest_sha256, update_control_t *control, const String &token)
+{
+  const char *TAG = "sync_files";
+  ESP_LOGI(TAG, "Manifest URL: %s\n", manifest_url.c_str());
+  if (!manifest_sha256)
+  {
+    ESP_LOGE(TAG, "No digest for the manifest, refusing to sync\n");
+    return false;
+  }
+
+  unsigned long started = millis();
+  uint32_t files = 0;
+  uint32_t manifest_bytes = 0;
+  std::vector<manifest_entry_t> changed;
+
+  OtaHttp https(transport);
+  https.follow_redirects(true);
+  github_authorize(https, token, true);
+  int httpCode = https.get(manifest_url);
+  if (httpCode != HTTP_CODE_OK)
+  {
+    ESP_LOGE(TAG, "[HTTPS] GET... failed, httpCode: %d\n", httpCode);
+    return false;
+  }
+
+  // Only entries that differ are kept, the manifest itself is streamed and
+  // hashed on the way
+  Sha256 hash;
+  String line;
+  int c;
+  do
+  {
+    c = https.stream().read();
+    if (c >= 0)
+    {
+      uint8_t byte = c;
+      hash.update(&byte, 1);
+      manifest_bytes++;
+    }
+    if (c >= 0 && c != '\n')
+    {
+      if (c != '\r')
+        line += (char)c;
+      continue;
+    }
+    if (line.length() == 0)
+      continue;
+
+    manifest_entry_t entry;
+    if (!parse_manifest_line(line, entry))
+    {
+      ESP_LOGE(TAG, "Malformed manifest line: %s\n", line.c_str());
+    }
+    else
+    {
+      files++;
+      if (!file_matches(fs, entry))
+      {
+        if (changed.size() == GITHUBOTA_SYNC_MAX_FILES)
+        {
+          ESP_LOGE(TAG, "More than %u files changed, refusing to sync\n", GITHUBOTA_SYNC_MAX_FILES);
+          https.end();
+          return false;
+        }
+        changed.push_back(entry);
+      }
+    }
+    line = "";
+  } while (c >= 0);
+  https.end();
+
+  // Nothing listed is fetched before the manifest is known to be the published one
+  uint8_t digest[SHA256_DIGEST_SIZE];
+  hash.finish(digest);
+  if (memcmp(digest, manifest_sha256, SHA256_DIGEST_SIZE) != 0)
+  {
+    ESP_LOGE(TAG, "Manifest digest mismatch (%u bytes), refusing to sync\n", manifest_bytes);
+    return false;
+  }
+
+  uint32_t downloaded = 0;
+  for (auto &entry : changed)
+  {
+    ESP_LOGI(TAG, "Updating %s (%u bytes)\n", entry.path.c_str(), entry.size);
+    if (!fetch_file(transport, fs, pack_url, entry, control, token))
+      return false;
+    downloaded += entry.size;
+  }
+
+  ESP_LOGI(TAG, "Synced %u of %u files: %u bytes (+%u manifest) in %lu ms\n",
+           changed.size(), files, downloaded, manifest_bytes, millis() - started);
+  return true;
+}
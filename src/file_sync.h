@@ -0,0 +1,44 @@
+#ifndef GITHUBOTA_FILE_SYNC_H
+#define GITHUBOTA_FILE_SYNC_H
+
+#include <FS.h>
+
+#include "transport.h"
+#include "common.h"
+
+// File-level filesystem updates.
+//
+// Next to (or instead of) the filesystem image a release carries a pack, the
+// plain concatenation of all files, and a manifest with one line per file:
+//
+//   <sha256 hex> <offset in pack> <size> <path>
+//
+// Both are produced by tools/fs_pack.py. Only files whose content differs are
+// fetched, each with a single Range request into the pack, written to a temporary
+// file, verified and renamed over the old one. Files missing from the manifest,
+// such as calibration data or logs, are left alone.
+//
+// The manifest vouches for every file, so it is only used once its own SHA-256
+// matches the digest GitHub publishes for the manifest asset. Until then the
+// changed files are held in memory, at most GITHUBOTA_SYNC_MAX_FILES of them;
+// a release changing more is refused and needs the filesystem image.
+#ifndef GITHUBOTA_SYNC_MAX_FILES
+#define GITHUBOTA_SYNC_MAX_FILES 64
+#endif
+
+struct manifest_entry_t
+{
+  String path;
+  uint32_t offset;
+  uint32_t size;
+  uint8_t sha256[SHA256_DIGEST_SIZE];
+};
+
+bool parse_manifest_line(const String &line, manifest_entry_t &entry);
+bool file_matches(fs::FS &fs, const manifest_entry_t &entry);
+// `manifest_sha256` is the digest of the manifest asset and required. With
+// `token` set, both URLs are asset API URLs (release_asset_t::url)
+bool sync_files(OtaTransport &transport, fs::FS &fs, String manifest_url, String pack_url,
+                const uint8_t *manifest_sha256, update_control_t *control = nullptr, const String &token = "");
+
+#endif
@@ -0,0 +1,90 @@
+#ifdef ESP32
+#include <Preferences.h>
+#include <esp_partition.h>
+
+#include "fs_slots.h"
+#include "common.h"
+#include "release_url.h"
+
+#define SLOT_NAMESPACE "github-ota"
+#define SLOT_KEY "fs_slot"
+#define SLOT_STATE_KEY "fs_state"
+
+// Slot and image version in one NVS blob, so they switch together
+struct fs_slot_state_t
+{
+  uint8_t slot;
+  char version[RELEASE_TAG_SIZE];
+};
+
+static bool slot_exists(const char *label)
+{
+  return esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label) != nullptr;
+}
+
+// Falls back to the slot stored by older versions, without a version
+static bool load_state(fs_slot_state_t &state)
+{
+  memset(&state, 0, sizeof(state));
+  Preferences prefs;
+  if (!prefs.begin(SLOT_NAMESPACE, true))
+    return false;
+
+  bool found = prefs.getBytesLength(SLOT_STATE_KEY) == sizeof(state) &&
+               prefs.getBytes(SLOT_STATE_KEY, &state, sizeof(state)) == sizeof(state);
+  if (!found)
+    state.slot = prefs.getUChar(SLOT_KEY, 0);
+  prefs.end();
+  state.version[sizeof(state.version) - 1] = '\0';
+  return found;
+}
+
+bool fs_slots_available()
+{
+  return slot_exists(GITHUBOTA_FS_SLOT_A) && slot_exists(GITHUBOTA_FS_SLOT_B);
+}
+
+// Slot A until an update switched to B
+const char *fs_slot_active()
+{
+  fs_slot_state_t state;
+  load_state(state);
+  return state.slot == 1 ? GITHUBOTA_FS_SLOT_B : GITHUBOTA_FS_SLOT_A;
+}
+
+const char *fs_slot_inactive()
+{
+  return strcmp(fs_slot_active(), GITHUBOTA_FS_SLOT_A) == 0 ? GITHUBOTA_FS_SLOT_B : GITHUBOTA_FS_SLOT_A;
+}
+
+bool fs_slot_activate(const char *label, const char *version)
+{
+  const char *TAG = "fs_slot_activate";
+
+  fs_slot_state_t state;
+  memset(&state, 0, sizeof(state));
+  state.slot = strcmp(label, GITHUBOTA_FS_SLOT_B) == 0 ? 1 : 0;
+  if (version)
+    strncpy(state.version, version, sizeof(state.version) - 1);
+
+  Preferences prefs;
+  if (!prefs.begin(SLOT_NAMESPACE, false))
+  {
+    ESP_LOGE(TAG, "NVS not available\n");
+    return false;
+  }
+  bool ok = prefs.putBytes(SLOT_STATE_KEY, &state, sizeof(state)) == sizeof(state);
+  prefs.end();
+  ESP_LOGI(TAG, "Active filesystem: %s\n", ok ? label : fs_slot_active());
+  return ok;
+}
+
+bool fs_slot_version(String &version)
+{
+  fs_slot_state_t state;
+  if (!load_state(state) || !state.version[0])
+    return false;
+  version = state.version;
+  return true;
+}
+#endif
@@ -0,0 +1,29 @@
+#ifndef GITHUBOTA_FS_SLOTS_H
+#define GITHUBOTA_FS_SLOTS_H
+
+#include <Arduino.h>
+
+// Labels of the two filesystem partitions in the partition table
+#ifndef GITHUBOTA_FS_SLOT_A
+#define GITHUBOTA_FS_SLOT_A "fs_a"
+#endif
+#ifndef GITHUBOTA_FS_SLOT_B
+#define GITHUBOTA_FS_SLOT_B "fs_b"
+#endif
+
+#ifdef ESP32
+// A/B filesystem layout: one slot stays mounted while the next image is written
+// into the other, which becomes the active one through a single NVS write once
+// it is complete and verified. Mount the active slot at boot, e.g.
+//   LittleFS.begin(false, "/littlefs", 10, fs_slot_active());
+// The ESP8266 core maps one fixed filesystem region, so it has no slots.
+bool fs_slots_available();
+const char *fs_slot_active();
+const char *fs_slot_inactive();
+// Switches to `label` and records the version of its image in the same write
+bool fs_slot_activate(const char *label, const char *version = nullptr);
+// Version recorded for the active slot, false when none was
+bool fs_slot_version(String &version);
+#endif
+
+#endif
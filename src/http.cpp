@@ -0,0 +1,373 @@
+#include <Arduino.h>
+
+#include "http.h"
+#include "common.h"
+#include "arena.h"
+
+bool parse_url(const String &url, url_t &out)
+{
+  int host_start;
+  if (url.startsWith("https://"))
+  {
+    out.secure = true;
+    out.port = 443;
+    host_start = 8;
+  }
+  else if (url.startsWith("http://"))
+  {
+    out.secure = false;
+    out.port = 80;
+    host_start = 7;
+  }
+  else
+  {
+    return false;
+  }
+
+  int path_start = url.indexOf('/', host_start);
+  String authority = path_start < 0 ? url.substring(host_start) : url.substring(host_start, path_start);
+  out.path = path_start < 0 ? String("/") : url.substring(path_start);
+
+  int colon = authority.indexOf(':');
+  if (colon >= 0)
+  {
+    out.port = authority.substring(colon + 1).toInt();
+    authority = authority.substring(0, colon);
+  }
+  out.host = authority;
+  return out.host.length() > 0 && out.port > 0;
+}
+
+HttpBody::HttpBody()
+{
+  _client = nullptr;
+  _chunked = false;
+  _done = true;
+  _remaining = 0;
+}
+
+void HttpBody::begin(Client *client, int length, bool chunked)
+{
+  _client = client;
+  _chunked = chunked;
+  _remaining = chunked ? 0 : length;
+  _done = !chunked && length == 0;
+}
+
+// Reads the next chunk-size line, consuming the trailer after the last chunk
+bool HttpBody::next_chunk()
+{
+  if (_done)
+    return false;
+
+  String line = _client->readStringUntil('\n');
+  line.trim();
+  if (line.length() == 0)
+    line = _client->readStringUntil('\n'); // CRLF closing the previous chunk
+
+  _remaining = strtol(line.c_str(), nullptr, 16);
+  if (_remaining > 0)
+    return true;
+
+  while (_client->readStringUntil('\n').length() > 1)
+  {
+    // Drop trailer headers
+  }
+  _done = true;
+  return false;
+}
+
+int HttpBody::available()
+{
+  if (_done || !_client)
+    return 0;
+  if (_chunked && _remaining == 0 && (!_client->available() || !next_chunk()))
+    return 0;
+
+  int available = _client->available();
+  return _remaining < 0 ? available : std::min(available, _remaining);
+}
+
+int HttpBody::read()
+{
+  uint8_t c;
+  return readBytes(&c, 1) == 1 ? c : -1;
+}
+
+int HttpBody::peek()
+{
+  if (_done || !_client)
+    return -1;
+  if (_chunked && _remaining == 0 && !next_chunk())
+    return -1;
+  return _client->peek();
+}
+
+// Bulk reads copy the decrypted data straight from the TLS layer into
+// `buffer`, Stream::readBytes() would go through read() byte by byte
+size_t HttpBody::readBytes(char *buffer, size_t length)
+{
+  size_t total = 0;
+  unsigned long last_data = millis();
+  while (total < length && !_done && _client)
+  {
+    if (_chunked && _remaining == 0 && !next_chunk())
+      break;
+
+    size_t wanted = length - total;
+    if (_remaining >= 0)
+      wanted = std::min(wanted, (size_t)_remaining);
+
+    int len = _client->read((uint8_t *)buffer + total, wanted);
+    if (len <= 0)
+    {
+      if (!_client->connected() || millis() - last_data > HTTP_TIMEOUT_MS)
+        break;
+      delay(1);
+      continue;
+    }
+    last_data = millis();
+
+    total += len;
+    if (_remaining >= 0)
+    {
+      _remaining -= len;
+      if (_remaining == 0 && !_chunked)
+        _done = true;
+    }
+  }
+  return total;
+}
+
+OtaHttp::OtaHttp(OtaTransport &transport) : _transport(transport)
+{
+  _client = nullptr;
+  _follow_redirects = false;
+  _keep_alive = false;
+  _size = -1;
+}
+
+OtaHttp::~OtaHttp()
+{
+  end();
+}
+
+void OtaHttp::follow_redirects(bool follow)
+{
+  _follow_redirects = follow;
+}
+
+void OtaHttp::add_header(const String &name, const String &value)
+{
+  _headers += name + ": " + value + "\r\n";
+}
+
+void OtaHttp::set_authorization(const String &value)
+{
+  _authorization = value;
+}
+
+int OtaHttp::get(const String &url)
+{
+  const char *TAG = "OtaHttp::get";
+
+  url_t target;
+  if (!parse_url(url, target))
+  {
+    ESP_LOGE(TAG, "Invalid URL: %s\n", url.c_str());
+    return -1;
+  }
+  _authorization_host = target.host;
+
+  for (int redirects = 0; redirects <= HTTP_MAX_REDIRECTS; redirects++)
+  {
+    int status = request(target);
+    bool redirect = status == 301 || status == 302 || status == 303 || status == 307 || status == 308;
+    if (!redirect || !_follow_redirects)
+    {
+      _url = (target.secure ? "https://" : "http://") + target.host + ":" + String(target.port) + target.path;
+      return status;
+    }
+
+    ESP_LOGV(TAG, "Redirect %d to %s\n", status, _location.c_str());
+    end();
+    if (_location.startsWith("/"))
+      target.path = _location;
+    else if (!parse_url(_location, target))
+      return -1;
+  }
+
+  ESP_LOGE(TAG, "Too many redirects\n");
+  return -1;
+}
+
+int OtaHttp::post(const String &url, const String &payload)
+{
+  const char *TAG = "OtaHttp::post";
+
+  url_t target;
+  if (!parse_url(url, target))
+  {
+    ESP_LOGE(TAG, "Invalid URL: %s\n", url.c_str());
+    return -1;
+  }
+  _authorization_host = target.host;
+
+  _payload = payload;
+  int status = request(target);
+  _payload = "";
+  _url = (target.secure ? "https://" : "http://") + target.host + ":" + String(target.port) + target.path;
+  return status;
+}
+
+int OtaHttp::request(const url_t &url)
+{
+  // A parked connection may have been closed by the server in the meantime,
+  // retry once on a fresh one
+  for (int attempt = 0; attempt < 2; attempt++)
+  {
+    _client = _transport.connect(url.host, url.port, url.secure);
+    if (!_client)
+      return -1;
+    bool reused = _transport.last_connection_reused();
+
+    int status = read_response(url);
+    if (status > 0 || !reused)
+      return status;
+  }
+  return -1;
+}
+
+int OtaHttp::read_response(const url_t &url)
+{
+  const char *TAG = "OtaHttp::read_response";
+
+  _size = -1;
+  _location = "";
+  _etag = "";
+  _keep_alive = true;
+
+  bool authorize = _authorization.length() > 0 && url.secure && url.host == _authorization_host;
+  bool post = _payload.length() > 0;
+  _client->print(String(post ? "POST " : "GET ") + url.path + " HTTP/1.1\r\n" +
+                 "Host: " + url.host + "\r\n" +
+                 "User-Agent: Esp-GitHub-OTA\r\n" +
+                 (authorize ? "Authorization: " + _authorization + "\r\n" : String("")) +
+                 (post ? "Content-Type: application/json\r\nContent-Length: " + String(_payload.length()) + "\r\n" : String("")) +
+                 _headers +
+                 "Connection: keep-alive\r\n\r\n");
+  if (post)
+    _client->print(_payload);
+
+  unsigned long start = millis();
+  while (!_client->available())
+  {
+    if (!_client->connected() || millis() - start > HTTP_TIMEOUT_MS)
+    {
+      ESP_LOGE(TAG, "No response from %s\n", url.host.c_str());
+      _keep_alive = false;
+      end();
+      return -1;
+    }
+    delay(1);
+  }
+
+  _client->setTimeout(HTTP_TIMEOUT_MS);
+  char *line = (char *)ota_malloc(HTTP_MAX_LINE);
+  if (!line)
+  {
+    ESP_LOGE(TAG, "Out of memory\n");
+    _keep_alive = false;
+    end();
+    return -1;
+  }
+
+  read_line(line);
+  const char *space = strchr(line, ' ');
+  int status = space ? atoi(space + 1) : -1;
+  if (status <= 0)
+  {
+    ESP_LOGE(TAG, "Malformed status line: %s\n", line);
+    ota_free(line);
+    _keep_alive = false;
+    end();
+    return -1;
+  }
+  if (strncmp(line, "HTTP/1.0", 8) == 0)
+    _keep_alive = false;
+
+  bool chunked = false;
+  while (_client->connected() || _client->available())
+  {
+    if (read_line(line) == 0)
+      break;
+
+    char *value = strchr(line, ':');
+    if (!value)
+      continue;
+    *value++ = '\0';
+    while (*value == ' ' || *value == '\t')
+      value++;
+
+    if (strcasecmp(line, "Content-Length") == 0)
+      _size = atoi(value);
+    else if (strcasecmp(line, "Location") == 0)
+      _location = value;
+    else if (strcasecmp(line, "ETag") == 0)
+      _etag = value;
+    else if (strcasecmp(line, "Transfer-Encoding") == 0)
+      chunked = strcasecmp(value, "chunked") == 0;
+    else if (strcasecmp(line, "Connection") == 0)
+      _keep_alive = _keep_alive && strcasecmp(value, "close") != 0;
+  }
+  ota_free(line);
+
+  if (!chunked && _size < 0)
+    _keep_alive = false;
+  _body.begin(_client, chunked ? -1 : _size, chunked);
+  return status;
+}
+
+// Reads one header line without its line ending into a HTTP_MAX_LINE buffer,
+// the rest of an overlong line is dropped
+size_t OtaHttp::read_line(char *line)
+{
+  size_t len = _client->readBytesUntil('\n', line, HTTP_MAX_LINE - 1);
+  if (len == HTTP_MAX_LINE - 1)
+    _client->find('\n');
+  while (len > 0 && (line[len - 1] == '\r' || line[len - 1] == ' '))
+    len--;
+  line[len] = '\0';
+  return len;
+}
+
+void OtaHttp::end()
+{
+  if (!_client)
+    return;
+
+  // Skip a small unread remainder (e.g. a redirect body) to keep the connection
+  uint8_t scrap[64];
+  size_t drained = 0;
+  while (_keep_alive && !_body.complete() && drained < HTTP_MAX_DRAIN)
+  {
+    size_t len = _body.readBytes(scrap, sizeof(scrap));
+    if (len == 0)
+      break;
+    drained += len;
+  }
+
+  _transport.release(_client, _keep_alive && _body.complete());
+  _client = nullptr;
+  _body.begin(nullptr, 0, false);
+}
+
+void github_authorize(OtaHttp &https, const String &token, bool asset)
+{
+  if (token.length() == 0)
+    return;
+
+  https.set_authorization("Bearer " + token);
+  if (asset)
+    https.add_header("Accept", "application/octet-stream");
+}
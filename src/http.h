@@ -0,0 +1,105 @@
+#ifndef GITHUBOTA_HTTP_H
+#define GITHUBOTA_HTTP_H
+
+#include <Arduino.h>
+#include "transport.h"
+
+#define HTTP_MAX_REDIRECTS 5
+#define HTTP_TIMEOUT_MS 10000
+// Leftover body bytes worth reading to keep a connection reusable
+#define HTTP_MAX_DRAIN 2048
+// Longest response header line kept, long enough for signed CDN redirects
+#define HTTP_MAX_LINE 1024
+
+struct url_t
+{
+  bool secure;
+  String host;
+  uint16_t port;
+  String path;
+};
+
+bool parse_url(const String &url, url_t &out);
+
+// Response body limited to Content-Length or decoded from chunked encoding,
+// so the connection is left at a message boundary and can be reused
+class HttpBody : public Stream
+{
+public:
+  HttpBody();
+
+  void begin(Client *client, int length, bool chunked);
+  bool complete() const { return _done; }
+
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t readBytes(char *buffer, size_t length);
+  size_t readBytes(uint8_t *buffer, size_t length) { return readBytes((char *)buffer, length); }
+  size_t write(uint8_t) override { return 0; }
+
+private:
+  bool next_chunk();
+
+  Client *_client;
+  bool _chunked;
+  bool _done;
+  // Bytes left in the body (Content-Length) or in the current chunk, -1 if unknown
+  int _remaining;
+};
+
+// Minimal HTTP/1.1 GET client running on top of an OtaTransport, so the
+// updater works over any Client and not only WiFiClientSecure.
+// Connections are kept alive and given back to the transport's pool.
+class OtaHttp
+{
+public:
+  OtaHttp(OtaTransport &transport);
+  ~OtaHttp();
+
+  void follow_redirects(bool follow);
+  // Extra request header sent with every request of this client, including redirects
+  void add_header(const String &name, const String &value);
+  // Authorization header value, only sent over TLS to the host of the initial
+  // request so it never leaks to the CDN host behind a redirect
+  void set_authorization(const String &value);
+
+  // Returns the HTTP status code or a negative value on connection errors
+  int get(const String &url);
+  // JSON request body, redirects are not followed
+  int post(const String &url, const String &payload);
+  void end();
+
+  int size() const { return _size; }
+  const String &location() const { return _location; }
+  const String &etag() const { return _etag; }
+  // URL the response came from after following redirects
+  const String &url() const { return _url; }
+  Stream &stream() { return _body; }
+
+private:
+  int request(const url_t &url);
+  int read_response(const url_t &url);
+  size_t read_line(char *line);
+
+  OtaTransport &_transport;
+  Client *_client;
+  HttpBody _body;
+  bool _follow_redirects;
+  bool _keep_alive;
+  int _size;
+  String _location;
+  String _etag;
+  String _url;
+  String _headers;
+  String _authorization;
+  String _authorization_host;
+  // Request body of a POST, GET when empty
+  String _payload;
+};
+
+// GitHub token authentication; asset API URLs are also asked for the binary
+// instead of the JSON description. A blank token leaves the request as is.
+void github_authorize(OtaHttp &https, const String &token, bool asset);
+
+#endif
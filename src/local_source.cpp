@@ -0,0 +1,110 @@
+#ifdef ESP8266
+#include <ESP8266HTTPClient.h>
+#elif defined(ESP32)
+#include <HTTPClient.h>
+#endif
+#include <FS.h>
+#include <ArduinoJson.h>
+
+#include "local_source.h"
+#include "http.h"
+#include "sha256.h"
+
+static bool parse_manifest(JsonDocument &doc, const String &location, release_ref_t &release, release_asset_t &asset)
+{
+  const char *TAG = "local_manifest_load";
+
+  const char *tag = doc["tag"];
+  const char *name = doc["name"];
+  if (!tag || !name || strlen(tag) >= sizeof(release.tag))
+  {
+    ESP_LOGE(TAG, "Manifest without tag or name\n");
+    return false;
+  }
+  asset.has_digest = parse_sha256_digest(doc["digest"], asset.sha256);
+  if (!asset.has_digest)
+  {
+    ESP_LOGE(TAG, "Manifest without SHA-256 digest\n");
+    return false;
+  }
+
+  memset(&release, 0, sizeof(release));
+  strncpy(release.tag, tag, sizeof(release.tag) - 1);
+  asset.name = name;
+  asset.size = doc["size"] | 0;
+  asset.label = doc["label"] | "";
+
+  // Relative to the directory of the manifest
+  if (name[0] == '/' || strstr(name, "://"))
+    asset.url = name;
+  else
+    asset.url = location.substring(0, location.lastIndexOf('/') + 1) + name;
+  ESP_LOGI(TAG, "Release %s at %s\n", release.tag, asset.url.c_str());
+  return true;
+}
+
+bool local_manifest_load(fs::FS *fs, OtaTransport &transport, const String &location,
+                         release_ref_t &release, release_asset_t &asset)
+{
+  const char *TAG = "local_manifest_load";
+
+  StaticJsonDocument<512> doc;
+  DeserializationError result;
+  if (fs)
+  {
+    File file = fs->open(location, "r");
+    if (!file)
+    {
+      ESP_LOGE(TAG, "No manifest at %s\n", location.c_str());
+      return false;
+    }
+    result = deserializeJson(doc, file);
+    file.close();
+  }
+  else
+  {
+    OtaHttp http(transport);
+    int httpCode = http.get(location);
+    if (httpCode != HTTP_CODE_OK)
+    {
+      ESP_LOGE(TAG, "[HTTP] GET %s failed, httpCode: %d\n", location.c_str(), httpCode);
+      http.end();
+      return false;
+    }
+    result = deserializeJson(doc, http.stream());
+    http.end();
+  }
+
+  if (result != DeserializationError::Ok)
+  {
+    ESP_LOGE(TAG, "deserializeJson error %s\n", result.c_str());
+    return false;
+  }
+  return parse_manifest(doc, location, release, asset);
+}
+
+bool local_update(fs::FS *fs, OtaTransport &transport, const release_asset_t &asset,
+                  int command, update_control_t *control)
+{
+  const char *TAG = "local_update";
+
+  if (!fs)
+    return download_update(transport, asset.url, asset.sha256, command, control);
+
+  File file = fs->open(asset.url, "r");
+  if (!file)
+  {
+    ESP_LOGE(TAG, "No image at %s\n", asset.url.c_str());
+    return false;
+  }
+  size_t size = file.size();
+  if (asset.size > 0 && size != (size_t)asset.size)
+  {
+    ESP_LOGE(TAG, "%s has %u bytes, the manifest says %d\n", asset.url.c_str(), size, asset.size);
+    file.close();
+    return false;
+  }
+  bool ok = update_from_stream(file, size, asset.sha256, command, control);
+  file.close();
+  return ok;
+}
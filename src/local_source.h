@@ -0,0 +1,31 @@
+#ifndef GITHUBOTA_LOCAL_SOURCE_H
+#define GITHUBOTA_LOCAL_SOURCE_H
+
+#include <Arduino.h>
+#include <FS.h>
+
+#include "common.h"
+#include "release_url.h"
+
+// Local update source for factory provisioning and field service without
+// internet access: a manifest on a filesystem (SD card, LittleFS) or on a
+// plain HTTP server describes the image next to it, e.g.
+//
+//   {"tag": "v1.2.3", "name": "firmware.bin", "size": 1048576,
+//    "digest": "sha256:<64 hex digits>", "label": "chip=ESP32-S3"}
+//
+// `name` is relative to the manifest's directory unless it is an absolute
+// path or URL. The digest is required, nothing else vouches for a local
+// image; `label` holds pre-flight requirements as on GitHub (see preflight.h).
+
+// Reads the manifest at `location`, a path on `fs` or an http:// URL when `fs`
+// is null, into the tag of `release` and `asset`, whose url is set to the
+// image's path or URL
+bool local_manifest_load(fs::FS *fs, OtaTransport &transport, const String &location,
+                         release_ref_t &release, release_asset_t &asset);
+
+// Writes the image of `asset` into the partition selected by `command`
+bool local_update(fs::FS *fs, OtaTransport &transport, const release_asset_t &asset,
+                  int command = U_FLASH, update_control_t *control = nullptr);
+
+#endif
@@ -0,0 +1,243 @@
+#ifdef ESP8266
+#include <Arduino.h>
+#include <stdarg.h>
+
+#include "log.h"
+
+#define LOG_LINE_SIZE 192
+#define LOG_STRING_SIZE 31
+
+#if GITHUBOTA_LOG_BUFFER > 0
+
+struct log_record_t
+{
+  // Whole record including the arguments that follow
+  uint16_t length;
+  uint8_t level;
+  uint8_t reserved;
+  uint32_t ms;
+  const char *tag;
+  const char *format;
+};
+
+#define LOG_RECORD_SIZE (sizeof(log_record_t) + 64)
+static_assert(GITHUBOTA_LOG_BUFFER >= 2 * LOG_RECORD_SIZE, "GITHUBOTA_LOG_BUFFER is too small");
+
+static uint8_t log_ring[GITHUBOTA_LOG_BUFFER];
+static size_t log_head = 0;
+static size_t log_used = 0;
+static uint32_t log_dropped = 0;
+
+static void ring_read(size_t pos, void *out, size_t len)
+{
+  for (size_t i = 0; i < len; i++)
+    ((uint8_t *)out)[i] = log_ring[(pos + i) % GITHUBOTA_LOG_BUFFER];
+}
+
+// Oldest records make room for the new one
+static void ring_write(const void *data, size_t len)
+{
+  while (log_used + len > GITHUBOTA_LOG_BUFFER && log_used > 0)
+  {
+    uint16_t length;
+    ring_read((log_head + GITHUBOTA_LOG_BUFFER - log_used) % GITHUBOTA_LOG_BUFFER, &length, sizeof(length));
+    log_used -= length;
+    log_dropped++;
+  }
+  for (size_t i = 0; i < len; i++)
+    log_ring[(log_head + i) % GITHUBOTA_LOG_BUFFER] = ((const uint8_t *)data)[i];
+  log_head = (log_head + len) % GITHUBOTA_LOG_BUFFER;
+  log_used += len;
+}
+
+// Walks the conversions of `format`, calling `visit` with the spec (e.g.
+// "%08lX") and the size of its argument: 4 or 8 bytes, 0 for a string and
+// -1 for "%%"
+template <typename Visit>
+static void each_conversion(const char *format, Visit visit, Print *literal)
+{
+  for (const char *p = format; *p; p++)
+  {
+    if (*p != '%')
+    {
+      if (literal)
+        literal->write(*p);
+      continue;
+    }
+
+    const char *start = p++;
+    int longs = 0;
+    while (*p && !strchr("diouxXcspfFeEgGaA%", *p))
+      longs += *p++ == 'l';
+    if (!*p)
+      break;
+
+    char spec[16];
+    size_t len = std::min((size_t)(p - start + 1), sizeof(spec) - 1);
+    memcpy(spec, start, len);
+    spec[len] = '\0';
+
+    if (*p == '%')
+      visit(spec, -1);
+    else if (*p == 's')
+      visit(spec, 0);
+    else if (strchr("fFeEgGaA", *p) || longs >= 2)
+      visit(spec, 8);
+    else
+      visit(spec, 4);
+  }
+}
+
+static void log_record(uint8_t level, const char *tag, const char *format, va_list args)
+{
+  // Arguments are packed behind the header, strings as length + characters
+  uint8_t record[LOG_RECORD_SIZE];
+  size_t pos = sizeof(log_record_t);
+  each_conversion(format, [&](const char *spec, int size) {
+    if (size == 0)
+    {
+      const char *s = va_arg(args, const char *);
+      if (pos >= sizeof(record))
+        return;
+      size_t len = s ? std::min(std::min(strlen(s), (size_t)LOG_STRING_SIZE), sizeof(record) - pos - 1) : 0;
+      record[pos++] = len;
+      if (len > 0)
+        memcpy(record + pos, s, len);
+      pos += len;
+    }
+    else if (size == 8)
+    {
+      // Floats are promoted to double, 64 bit integers share the size
+      uint64_t value;
+      if (strpbrk(spec, "fFeEgGaA"))
+      {
+        double d = va_arg(args, double);
+        memcpy(&value, &d, sizeof(value));
+      }
+      else
+      {
+        value = va_arg(args, uint64_t);
+      }
+      if (pos + 8 <= sizeof(record))
+      {
+        memcpy(record + pos, &value, 8);
+        pos += 8;
+      }
+    }
+    else if (size == 4)
+    {
+      uint32_t value = va_arg(args, uint32_t);
+      if (pos + 4 <= sizeof(record))
+      {
+        memcpy(record + pos, &value, 4);
+        pos += 4;
+      }
+    }
+  }, nullptr);
+
+  log_record_t header = {(uint16_t)pos, level, 0, (uint32_t)millis(), tag, format};
+  memcpy(record, &header, sizeof(header));
+  ring_write(record, pos);
+}
+
+size_t ota_log_drain(Print &out)
+{
+  size_t count = 0;
+  while (log_used > 0)
+  {
+    uint8_t record[LOG_RECORD_SIZE];
+    size_t tail = (log_head + GITHUBOTA_LOG_BUFFER - log_used) % GITHUBOTA_LOG_BUFFER;
+    log_record_t header;
+    ring_read(tail, &header, sizeof(header));
+    ring_read(tail, record, std::min((size_t)header.length, sizeof(record)));
+    log_used -= header.length;
+
+    out.printf("%u [ %s ] ", header.ms, header.tag);
+    size_t pos = sizeof(log_record_t);
+    each_conversion(header.format, [&](const char *spec, int size) {
+      char text[LOG_STRING_SIZE + 1];
+      if (size == -1)
+      {
+        out.write('%');
+      }
+      else if (size == 0 && pos < header.length)
+      {
+        size_t len = std::min((size_t)record[pos++], (size_t)LOG_STRING_SIZE);
+        memcpy(text, record + pos, len);
+        text[len] = '\0';
+        pos += len;
+        out.printf(spec, text);
+      }
+      else if (size == 8 && pos + 8 <= header.length)
+      {
+        uint64_t value;
+        memcpy(&value, record + pos, 8);
+        pos += 8;
+        if (strpbrk(spec, "fFeEgGaA"))
+        {
+          double d;
+          memcpy(&d, &value, sizeof(d));
+          out.printf(spec, d);
+        }
+        else
+        {
+          out.printf(spec, value);
+        }
+      }
+      else if (size == 4 && pos + 4 <= header.length)
+      {
+        uint32_t value;
+        memcpy(&value, record + pos, 4);
+        pos += 4;
+        out.printf(spec, value);
+      }
+    }, &out);
+    count++;
+  }
+  return count;
+}
+
+uint32_t ota_log_dropped()
+{
+  return log_dropped;
+}
+
+#endif
+
+void ota_log(uint8_t level, const char *tag, const char *format, ...)
+{
+  va_list args;
+  va_start(args, format);
+#if GITHUBOTA_LOG_BUFFER > 0
+  log_record(level, tag, format, args);
+#else
+  // Longer lines are formatted into the heap, as Print::printf() does
+  char line[LOG_LINE_SIZE];
+  va_list retry;
+  va_copy(retry, args);
+  int len = vsnprintf(line, sizeof(line), format, args);
+  char *text = line;
+  if (len >= (int)sizeof(line))
+  {
+    text = (char *)malloc(len + 1);
+    if (text)
+      vsnprintf(text, len + 1, format, retry);
+  }
+  va_end(retry);
+  Serial.printf("[ %s ] ", tag);
+  if (text)
+  {
+    Serial.print(text);
+  }
+  else
+  {
+    // Out of memory: the cut line is marked, it has lost its newline
+    Serial.print(line);
+    Serial.print("...\n");
+  }
+  if (text != line)
+    free(text);
+#endif
+  va_end(args);
+}
+#endif
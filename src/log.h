@@ -0,0 +1,47 @@
+#ifndef GITHUBOTA_LOG_H
+#define GITHUBOTA_LOG_H
+
+#include <Arduino.h>
+
+#define GITHUBOTA_LOG_NONE 0
+#define GITHUBOTA_LOG_ERROR 1
+#define GITHUBOTA_LOG_WARN 2
+#define GITHUBOTA_LOG_INFO 3
+#define GITHUBOTA_LOG_DEBUG 4
+#define GITHUBOTA_LOG_VERBOSE 5
+
+// Messages above this level are compiled out, arguments included
+#ifndef GITHUBOTA_LOG_LEVEL
+#define GITHUBOTA_LOG_LEVEL GITHUBOTA_LOG_INFO
+#endif
+
+// Bytes of RAM for deferred logging, 0 prints right away
+#ifndef GITHUBOTA_LOG_BUFFER
+#define GITHUBOTA_LOG_BUFFER 0
+#endif
+
+#ifdef ESP8266
+// Logging shim for the ESP8266, which has no ESP_LOGx. With a log buffer a
+// message is stored as a compact binary record: level, time, the addresses of
+// the tag and format literals and the raw arguments, strings copied up to 31
+// characters. No formatting and no UART access happen until the records are
+// drained, e.g. into Serial or a network client.
+void ota_log(uint8_t level, const char *tag, const char *format, ...) __attribute__((format(printf, 3, 4)));
+
+#if GITHUBOTA_LOG_BUFFER > 0
+// Formats and prints the buffered records oldest first and removes them,
+// returns the number of records printed
+size_t ota_log_drain(Print &out);
+// Records overwritten before they were drained
+uint32_t ota_log_dropped();
+#endif
+
+#define GITHUBOTA_LOG(level, tag, ...)          \
+  do                                            \
+  {                                             \
+    if ((level) <= GITHUBOTA_LOG_LEVEL)         \
+      ota_log((level), (tag), __VA_ARGS__);     \
+  } while (0)
+#endif
+
+#endif
@@ -0,0 +1,238 @@
+#ifdef ESP32
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include <esp_ota_ops.h>
+#include <esp_partition.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include "parallel.h"
+#include "partition_writer.h"
+#include "arena.h"
+#include "sha256.h"
+
+#define PARALLEL_STACK_SIZE 4096
+#define PARALLEL_TIMEOUT_MS 10000
+
+struct range_job_t
+{
+  Stream *stream;
+  const esp_partition_t *partition;
+  size_t start;
+  size_t end;
+  uint8_t *buffer;
+  SemaphoreHandle_t flash_lock;
+  SemaphoreHandle_t finished;
+  update_control_t *control;
+  volatile size_t received;
+  volatile bool failed;
+};
+
+// Streams one region into flash, a sector at a time
+static void range_task(void *arg)
+{
+  auto job = (range_job_t *)arg;
+  size_t offset = job->start;
+  size_t buffered = 0;
+  unsigned long last_data = millis();
+
+  while (offset < job->end)
+  {
+    if (job->control->cancelled)
+    {
+      job->failed = true;
+      break;
+    }
+    if (job->control->paused)
+    {
+      delay(10);
+      last_data = millis();
+      continue;
+    }
+
+    size_t wanted = std::min((size_t)PARTITION_SECTOR_SIZE - buffered, job->end - offset - buffered);
+    size_t len = job->stream->available() ? job->stream->readBytes(job->buffer + buffered, wanted) : 0;
+    if (len == 0)
+    {
+      if (millis() - last_data > PARALLEL_TIMEOUT_MS)
+      {
+        job->failed = true;
+        break;
+      }
+      delay(1);
+      continue;
+    }
+    last_data = millis();
+    buffered += len;
+    job->received += len;
+
+    if (buffered < PARTITION_SECTOR_SIZE && offset + buffered < job->end)
+      continue;
+
+    // Pad the tail of the image to the 4 byte flash word size
+    size_t padded = (buffered + 3) & ~3;
+    memset(job->buffer + buffered, 0xFF, padded - buffered);
+
+    xSemaphoreTake(job->flash_lock, portMAX_DELAY);
+    bool ok = esp_partition_erase_range(job->partition, offset, PARTITION_SECTOR_SIZE) == ESP_OK &&
+              esp_partition_write(job->partition, offset, job->buffer, padded) == ESP_OK;
+    xSemaphoreGive(job->flash_lock);
+    if (!ok)
+    {
+      job->failed = true;
+      break;
+    }
+    offset += buffered;
+    buffered = 0;
+  }
+
+  xSemaphoreGive(job->finished);
+  vTaskDelete(nullptr);
+}
+
+static bool verify_partition(const esp_partition_t *partition, size_t size, const uint8_t *sha256, uint8_t *buffer)
+{
+  Sha256 hash;
+  for (size_t offset = 0; offset < size; offset += PARTITION_SECTOR_SIZE)
+  {
+    size_t len = std::min(size - offset, (size_t)PARTITION_SECTOR_SIZE);
+    if (esp_partition_read(partition, offset, buffer, len) != ESP_OK)
+      return false;
+    hash.update(buffer, len);
+  }
+
+  uint8_t digest[SHA256_DIGEST_SIZE];
+  hash.finish(digest);
+  return memcmp(digest, sha256, SHA256_DIGEST_SIZE) == 0;
+}
+
+bool parallel_update(OtaTransport &transport, OtaHttp &first, const uint8_t *sha256, int command,
+                     update_control_t *control, bool &fallback)
+{
+  const char *TAG = "parallel_update";
+
+  size_t size = first.size();
+  size_t streams = std::min(std::min((size_t)control->streams, (size_t)PARALLEL_MAX_STREAMS), (size_t)GITHUBOTA_POOL_SIZE);
+  size_t region = (size / streams + PARTITION_SECTOR_SIZE - 1) & ~(size_t)(PARTITION_SECTOR_SIZE - 1);
+  streams = (size + region - 1) / region;
+  fallback = true;
+
+  const esp_partition_t *partition = target_partition(command, control->partition);
+  if (!partition || size > partition->size)
+  {
+    ESP_LOGE(TAG, "Image of %u bytes does not fit\n", size);
+    fallback = false;
+    return false;
+  }
+
+  // Open the range requests one after the other, the transport is not shared
+  // between tasks
+  OtaHttp *https[PARALLEL_MAX_STREAMS] = {&first};
+  range_job_t jobs[PARALLEL_MAX_STREAMS];
+  bool ready = true;
+  size_t opened = 1;
+  for (; opened < streams && ready; opened++)
+  {
+    size_t start = opened * region;
+    size_t end = std::min(start + region, size);
+    https[opened] = new OtaHttp(transport);
+    https[opened]->add_header("Range", "bytes=" + String(start) + "-" + String(end - 1));
+    int httpCode = https[opened]->get(first.url());
+    if (httpCode != HTTP_CODE_PARTIAL_CONTENT || https[opened]->size() != (int)(end - start))
+    {
+      ESP_LOGI(TAG, "Range request failed (%d), using a single stream\n", httpCode);
+      ready = false;
+    }
+  }
+
+  SemaphoreHandle_t flash_lock = ready ? xSemaphoreCreateMutex() : nullptr;
+  SemaphoreHandle_t finished = ready ? xSemaphoreCreateCounting(streams, 0) : nullptr;
+  ready = ready && flash_lock && finished;
+  for (size_t i = 0; i < streams; i++)
+  {
+    jobs[i].buffer = ready ? (uint8_t *)ota_malloc(PARTITION_SECTOR_SIZE) : nullptr;
+    ready = ready && jobs[i].buffer;
+  }
+
+  bool ok = false;
+  if (ready)
+  {
+    fallback = false;
+    update_started();
+    ESP_LOGI(TAG, "%u bytes over %u streams\n", size, streams);
+
+    unsigned long started = millis();
+    for (size_t i = 0; i < streams; i++)
+    {
+      jobs[i].stream = &https[i]->stream();
+      jobs[i].partition = partition;
+      jobs[i].start = i * region;
+      jobs[i].end = std::min((i + 1) * region, size);
+      jobs[i].flash_lock = flash_lock;
+      jobs[i].finished = finished;
+      jobs[i].control = control;
+      jobs[i].received = 0;
+      jobs[i].failed = false;
+      if (xTaskCreate(range_task, "ota_range", PARALLEL_STACK_SIZE, &jobs[i], uxTaskPriorityGet(nullptr), nullptr) != pdPASS)
+      {
+        jobs[i].failed = true;
+        xSemaphoreGive(finished);
+      }
+    }
+
+    // Report progress until every region is in
+    update_stats_t stats = {0, 0, 0, 0, 0};
+    size_t done = 0;
+    while (done < streams)
+    {
+      if (xSemaphoreTake(finished, pdMS_TO_TICKS(100)) == pdTRUE)
+        done++;
+
+      size_t received = 0;
+      for (size_t i = 0; i < streams; i++)
+        received += jobs[i].received;
+      stats.elapsed_ms = millis() - started;
+      stats.bytes_per_sec = stats.elapsed_ms ? (uint64_t)received * 1000 / stats.elapsed_ms : 0;
+      stats.sectors_written = (received + PARTITION_SECTOR_SIZE - 1) / PARTITION_SECTOR_SIZE;
+      if (control->progress)
+        control->progress(control->ctx, received, size, stats);
+    }
+
+    ok = true;
+    for (size_t i = 0; i < streams; i++)
+      ok = ok && !jobs[i].failed;
+    ESP_LOGI(TAG, "%u bytes in %u ms (%u B/s)\n", size, stats.elapsed_ms, stats.bytes_per_sec);
+
+    if (ok && sha256 && !verify_partition(partition, size, sha256, jobs[0].buffer))
+    {
+      ESP_LOGE(TAG, "SHA-256 mismatch, discarding image\n");
+      ok = false;
+    }
+    // Validates the image before switching the boot partition
+    if (ok && command == U_FLASH && esp_ota_set_boot_partition(partition) != ESP_OK)
+    {
+      ESP_LOGE(TAG, "Image verification failed\n");
+      ok = false;
+    }
+
+    if (ok)
+      update_finished();
+    else
+      update_error(-1);
+  }
+
+  for (size_t i = streams; i > 0; i--)
+    ota_free(jobs[i - 1].buffer);
+  if (flash_lock)
+    vSemaphoreDelete(flash_lock);
+  if (finished)
+    vSemaphoreDelete(finished);
+  for (size_t i = 1; i < opened; i++)
+  {
+    https[i]->end();
+    delete https[i];
+  }
+  return ok;
+}
+#endif
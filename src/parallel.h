@@ -0,0 +1,27 @@
+#ifndef GITHUBOTA_PARALLEL_H
+#define GITHUBOTA_PARALLEL_H
+
+#include <Arduino.h>
+
+#include "common.h"
+#include "http.h"
+
+#define PARALLEL_MAX_STREAMS 4
+// Below this size the extra TLS handshakes cost more than they save
+#ifndef PARALLEL_MIN_SIZE
+#define PARALLEL_MIN_SIZE (256 * 1024)
+#endif
+
+#ifdef ESP32
+// Splits the image into sector aligned regions and fetches them over
+// `control->streams` concurrent connections, the first one being the already
+// open `first` response, the others HTTP Range requests to its final URL.
+// Flash writes are serialized, the whole image is hashed from flash once all
+// regions are in. Sets `fallback` and returns false without touching flash
+// when the server does not serve the ranges, so the caller can continue with
+// `first` as a single stream.
+bool parallel_update(OtaTransport &transport, OtaHttp &first, const uint8_t *sha256, int command,
+                     update_control_t *control, bool &fallback);
+#endif
+
+#endif
@@ -0,0 +1,305 @@
+#include <Arduino.h>
+
+#ifdef ESP8266
+#include <Updater.h>
+#include <flash_hal.h>
+#elif defined(ESP32)
+#include <Update.h>
+#include <esp_ota_ops.h>
+#include <esp_partition.h>
+#include <esp_image_format.h>
+#endif
+
+#include "partition_writer.h"
+#include "arena.h"
+#include "common.h"
+
+#define ESP_IMAGE_MAGIC 0xE9
+#define COMPARE_CHUNK 256
+// The Updater has a sector buffer of its own, it is fed in smaller pieces
+#define UPDATER_CHUNK 1024
+
+PartitionWriter::PartitionWriter(int command, const char *label)
+{
+  _use_updater = false;
+  _command = command;
+  _label = label;
+#ifdef ESP8266
+  _address = 0;
+#elif defined(ESP32)
+  _partition = nullptr;
+#endif
+  _size = 0;
+  _offset = 0;
+  _buffered = 0;
+  _sector = nullptr;
+  _sectors_written = 0;
+  _sectors_skipped = 0;
+}
+
+PartitionWriter::~PartitionWriter()
+{
+  release();
+}
+
+#ifdef ESP32
+const esp_partition_t *target_partition(int command, const char *label)
+{
+  if (command == U_FLASH)
+    return esp_ota_get_next_update_partition(nullptr);
+  if (label)
+    return esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+  return esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, nullptr);
+}
+#endif
+
+size_t PartitionWriter::capacity(int command, const char *label)
+{
+#ifdef ESP8266
+  // Same limit as Updater::begin(), the new sketch is staged in free space
+  if (command == U_FLASH)
+    return (ESP.getFreeSketchSpace() - 0x1000) & 0xFFFFF000;
+  return FS_PHYS_SIZE;
+#elif defined(ESP32)
+  const esp_partition_t *partition = target_partition(command, label);
+  return partition ? partition->size : 0;
+#endif
+}
+
+bool PartitionWriter::begin(size_t size)
+{
+  const char *TAG = "PartitionWriter::begin";
+
+  _size = size;
+  _offset = 0;
+  _buffered = 0;
+  _sectors_written = 0;
+  _sectors_skipped = 0;
+
+#ifdef ESP8266
+  _use_updater = _command == U_FLASH;
+  if (_use_updater)
+  {
+#ifdef LED_BUILTIN
+    bool began = Update.begin(size, _command, LED_BUILTIN, LOW);
+#else
+    bool began = Update.begin(size, _command);
+#endif
+    if (!began)
+    {
+      ESP_LOGE(TAG, "Update.begin failed: %d\n", Update.getError());
+      return false;
+    }
+  }
+  _address = FS_PHYS_ADDR;
+#elif defined(ESP32)
+  _use_updater = false;
+  _partition = target_partition(_command, _label);
+  if (!_partition)
+  {
+    ESP_LOGE(TAG, "No target partition\n");
+    return false;
+  }
+#endif
+
+  // The Updater checks the size itself
+  size_t capacity = PartitionWriter::capacity(_command, _label);
+  if (!_use_updater && (size == 0 || size > capacity))
+  {
+    ESP_LOGE(TAG, "Image of %u bytes does not fit into %u bytes\n", size, capacity);
+    return false;
+  }
+
+  _sector = (uint32_t *)ota_malloc(buffer_size());
+  if (!_sector)
+  {
+    ESP_LOGE(TAG, "Out of memory\n");
+    if (_use_updater)
+      Update.end();
+    return false;
+  }
+  return true;
+}
+
+size_t PartitionWriter::write(const uint8_t *data, size_t len)
+{
+  if (_use_updater)
+    return Update.write(const_cast<uint8_t *>(data), len);
+
+  size_t done = 0;
+  while (done < len)
+  {
+    size_t chunk = len - done;
+    uint8_t *buffer = reserve(chunk);
+    if (!buffer)
+      return 0;
+    memcpy(buffer, data + done, chunk);
+    if (!commit(chunk))
+      return 0;
+    done += chunk;
+  }
+  return done;
+}
+
+uint8_t *PartitionWriter::reserve(size_t &len)
+{
+  if (!_sector)
+    return nullptr;
+
+  len = std::min(len, _size - _offset - _buffered);
+  len = std::min(len, buffer_size() - _buffered);
+  return len > 0 ? (uint8_t *)_sector + _buffered : nullptr;
+}
+
+size_t PartitionWriter::buffer_size() const
+{
+  return _use_updater ? UPDATER_CHUNK : PARTITION_SECTOR_SIZE;
+}
+
+bool PartitionWriter::commit(size_t len)
+{
+  uint8_t *data = (uint8_t *)_sector + _buffered;
+  if (_use_updater)
+  {
+    // The Updater stages the image in its own buffer
+    _offset += len;
+    return Update.write(data, len) == len;
+  }
+
+  if (_command == U_FLASH && _offset == 0 && _buffered == 0 && len > 0 && data[0] != ESP_IMAGE_MAGIC)
+  {
+    ESP_LOGE("PartitionWriter::commit", "Not an app image (magic 0x%02X)\n", data[0]);
+    return false;
+  }
+
+  _buffered += len;
+  return _buffered < PARTITION_SECTOR_SIZE || flush_sector();
+}
+
+// An app image built for another chip is rejected before anything is erased
+bool PartitionWriter::header_compatible(const uint8_t *data, size_t len)
+{
+#if defined(ESP32) && defined(CONFIG_IDF_FIRMWARE_CHIP_ID)
+  if (_command != U_FLASH || len < sizeof(esp_image_header_t))
+    return true;
+
+  const esp_image_header_t *header = (const esp_image_header_t *)data;
+  if (header->chip_id != CONFIG_IDF_FIRMWARE_CHIP_ID)
+  {
+    ESP_LOGE("PartitionWriter::header_compatible", "Image is built for chip id %u, this is %u\n",
+             header->chip_id, CONFIG_IDF_FIRMWARE_CHIP_ID);
+    return false;
+  }
+#endif
+  return true;
+}
+
+bool PartitionWriter::flush_sector()
+{
+  const char *TAG = "PartitionWriter::flush_sector";
+  if (_buffered == 0)
+    return true;
+
+  // Pad the tail of the image to the 4 byte flash word size
+  size_t len = (_buffered + 3) & ~3;
+  memset((uint8_t *)_sector + _buffered, 0xFF, len - _buffered);
+
+  if (_offset == 0 && !header_compatible((const uint8_t *)_sector, len))
+    return false;
+
+  if (sector_matches(_offset, (const uint8_t *)_sector, len))
+  {
+    _sectors_skipped++;
+  }
+  else
+  {
+    if (!erase_sector(_offset) || !program(_offset, (const uint8_t *)_sector, len))
+    {
+      ESP_LOGE(TAG, "Flash write failed at 0x%X\n", _offset);
+      return false;
+    }
+    _sectors_written++;
+  }
+
+  _offset += _buffered;
+  _buffered = 0;
+  return true;
+}
+
+bool PartitionWriter::sector_matches(uint32_t offset, const uint8_t *data, size_t len)
+{
+  uint32_t current[COMPARE_CHUNK / sizeof(uint32_t)];
+  for (size_t pos = 0; pos < len; pos += COMPARE_CHUNK)
+  {
+    size_t chunk = std::min(len - pos, (size_t)COMPARE_CHUNK);
+#ifdef ESP8266
+    if (!ESP.flashRead(_address + offset + pos, current, chunk))
+      return false;
+#elif defined(ESP32)
+    if (esp_partition_read(_partition, offset + pos, current, chunk) != ESP_OK)
+      return false;
+#endif
+    if (memcmp(current, data + pos, chunk) != 0)
+      return false;
+  }
+  return true;
+}
+
+bool PartitionWriter::erase_sector(uint32_t offset)
+{
+#ifdef ESP8266
+  return ESP.flashEraseSector((_address + offset) / PARTITION_SECTOR_SIZE);
+#elif defined(ESP32)
+  return esp_partition_erase_range(_partition, offset, PARTITION_SECTOR_SIZE) == ESP_OK;
+#endif
+}
+
+bool PartitionWriter::program(uint32_t offset, const uint8_t *data, size_t len)
+{
+#ifdef ESP8266
+  return ESP.flashWrite(_address + offset, (const uint32_t *)data, len);
+#elif defined(ESP32)
+  return esp_partition_write(_partition, offset, data, len) == ESP_OK;
+#endif
+}
+
+bool PartitionWriter::finalize()
+{
+  const char *TAG = "PartitionWriter::finalize";
+
+  if (_use_updater)
+    return Update.end();
+
+  bool ok = _sector && flush_sector() && _offset == _size;
+  release();
+  if (!ok)
+  {
+    ESP_LOGE(TAG, "Incomplete image: %u of %u bytes\n", _offset, _size);
+    return false;
+  }
+
+  ESP_LOGI(TAG, "Sectors written: %u, skipped (unchanged): %u\n", _sectors_written, _sectors_skipped);
+#ifdef ESP32
+  // Validates the image before switching the boot partition
+  if (_command == U_FLASH && esp_ota_set_boot_partition(_partition) != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Image verification failed\n");
+    return false;
+  }
+#endif
+  return true;
+}
+
+void PartitionWriter::abort()
+{
+  // Ending an unfinished Updater session discards it
+  if (_use_updater)
+    Update.end();
+  release();
+}
+
+void PartitionWriter::release()
+{
+  ota_free(_sector);
+  _sector = nullptr;
+}
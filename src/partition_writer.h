@@ -0,0 +1,82 @@
+#ifndef GITHUBOTA_PARTITION_WRITER_H
+#define GITHUBOTA_PARTITION_WRITER_H
+
+#include <Arduino.h>
+
+#ifdef ESP8266
+#include <Updater.h>
+#elif defined(ESP32)
+#include <Update.h>
+#include <esp_partition.h>
+#endif
+
+#include "sink.h"
+
+#define PARTITION_SECTOR_SIZE 4096
+
+// Streams an image into the app or filesystem partition one flash sector at a
+// time. Every sector is compared against what is already in flash and is only
+// erased and programmed when it differs, which saves time and flash endurance
+// when consecutive images share large regions (typically LittleFS images).
+//
+// The ESP8266 app image is staged by the core's Updater and copied into place by
+// eboot on reboot, which rewrites it as a whole, so it is passed through as is.
+//
+// On ESP32 `label` selects a data partition other than the default filesystem
+// one.
+class PartitionWriter : public OtaSink
+{
+public:
+  PartitionWriter(int command = U_FLASH, const char *label = nullptr);
+  ~PartitionWriter();
+
+  // Largest image the partition selected by `command` takes. On ESP32 `label`
+  // selects a data partition other than the default filesystem one.
+  static size_t capacity(int command, const char *label = nullptr);
+
+  bool begin(size_t size) override;
+  size_t write(const uint8_t *data, size_t len) override;
+  // In-place writing: the image is read straight into the sector buffer
+  // instead of the block of the base class
+  uint8_t *reserve(size_t &len) override;
+  bool commit(size_t len) override;
+  // Flushes the last sector and activates the image
+  bool finalize() override;
+  void abort() override;
+  size_t sector_size() const override { return buffer_size(); }
+
+  uint32_t sectors_written() const override { return _sectors_written; }
+  uint32_t sectors_skipped() const override { return _sectors_skipped; }
+
+private:
+  size_t buffer_size() const;
+  bool header_compatible(const uint8_t *data, size_t len);
+  bool flush_sector();
+  bool sector_matches(uint32_t offset, const uint8_t *data, size_t len);
+  bool erase_sector(uint32_t offset);
+  bool program(uint32_t offset, const uint8_t *data, size_t len);
+  void release();
+
+  bool _use_updater;
+  int _command;
+  const char *_label;
+#ifdef ESP8266
+  uint32_t _address;
+#elif defined(ESP32)
+  const esp_partition_t *_partition;
+#endif
+  size_t _size;
+  size_t _offset;
+  size_t _buffered;
+  uint32_t *_sector;
+  uint32_t _sectors_written;
+  uint32_t _sectors_skipped;
+};
+
+#ifdef ESP32
+// Next OTA app partition for U_FLASH, the data partition named `label` or the
+// filesystem data partition otherwise
+const esp_partition_t *target_partition(int command, const char *label = nullptr);
+#endif
+
+#endif
@@ -0,0 +1,278 @@
+#ifdef ESP8266
+#include <ESP8266WiFi.h>
+#include <ESP8266HTTPClient.h>
+#elif defined(ESP32)
+#include <WiFi.h>
+#include <HTTPClient.h>
+#include <esp_ota_ops.h>
+#endif
+
+#include "semver_extensions.h"
+#include "peer.h"
+#include "common.h"
+#include "http.h"
+
+#define PEER_QUERY "GHOTA?"
+#define PEER_ANSWER "GHOTA!"
+#define PEER_CHUNK_SIZE 1024
+
+OtaPeer::OtaPeer(uint16_t port) : _server(port)
+{
+  _port = port;
+  _running = false;
+  _version = {0, 0, 0, nullptr, nullptr};
+  _request_len = 0;
+  _accepted_at = 0;
+  _serving = false;
+  _offset = 0;
+  _image_size = 0;
+}
+
+void OtaPeer::begin(semver_t version, String asset_name)
+{
+  const char *TAG = "OtaPeer::begin";
+
+#ifdef ESP8266
+  ESP_LOGE(TAG, "Serving is not supported on ESP8266, the installed image differs from the published one\n");
+  return;
+#endif
+  _version = version;
+  _asset_name = asset_name;
+  _image_size = ESP.getSketchSize();
+
+  _udp.begin(_port);
+  _server.begin();
+  _running = true;
+
+  ESP_LOGI(TAG, "Serving %s %s (%u bytes) on port %u\n",
+           _asset_name.c_str(), to_string(_version).c_str(), _image_size, _port);
+}
+
+void OtaPeer::handle()
+{
+  if (!_running)
+    return;
+
+  answer_query();
+  if (!_client.connected())
+    accept_client();
+  if (!_client.connected())
+    return;
+  if (_serving)
+    serve_client();
+  else
+    read_request();
+}
+
+void OtaPeer::answer_query()
+{
+  const char *TAG = "OtaPeer::answer_query";
+
+  int len = _udp.parsePacket();
+  if (len <= 0)
+    return;
+
+  char packet[96];
+  len = _udp.read(packet, sizeof(packet) - 1);
+  if (len <= 0)
+    return;
+  packet[len] = '\0';
+
+  char asset[48], version[40];
+  if (sscanf(packet, PEER_QUERY " %47s %39s", asset, version) != 2)
+    return;
+
+  auto wanted = from_string(version);
+  bool match = _asset_name == asset && semver_eq(wanted, _version);
+  release_version(wanted);
+  if (!match)
+    return;
+
+  ESP_LOGV(TAG, "Query for %s %s from %s\n", asset, version, _udp.remoteIP().toString().c_str());
+  _udp.beginPacket(_udp.remoteIP(), _udp.remotePort());
+  _udp.printf(PEER_ANSWER " %s %s %u", asset, version, _port);
+  _udp.endPacket();
+}
+
+void OtaPeer::accept_client()
+{
+  _client = _server.available();
+  if (!_client)
+    return;
+
+  _request_len = 0;
+  _accepted_at = millis();
+  _serving = false;
+}
+
+// Collects the request line from what has arrived so far, a slow or idle
+// client never holds up loop()
+void OtaPeer::read_request()
+{
+  const char *TAG = "OtaPeer::read_request";
+
+  while (_client.available() && _request_len < sizeof(_request) - 1)
+  {
+    int c = _client.read();
+    if (c == '\n')
+    {
+      _request[_request_len] = '\0';
+      respond();
+      return;
+    }
+    if (c != '\r')
+      _request[_request_len++] = c;
+  }
+
+  if (_request_len >= sizeof(_request) - 1 || millis() - _accepted_at > GITHUBOTA_PEER_REQUEST_TIMEOUT_MS)
+  {
+    ESP_LOGI(TAG, "Dropping client without a request\n");
+    _client.stop();
+  }
+}
+
+void OtaPeer::respond()
+{
+  const char *TAG = "OtaPeer::respond";
+
+  // "GET /<asset> HTTP/1.1", the request headers are not needed
+  bool match = strncmp(_request, "GET /", 5) == 0 &&
+               strncmp(_request + 5, _asset_name.c_str(), _asset_name.length()) == 0 &&
+               _request[5 + _asset_name.length()] == ' ';
+  if (!match)
+  {
+    ESP_LOGI(TAG, "Rejecting request: %s\n", _request);
+    _client.print("HTTP/1.1 404 Not Found\r\nConnection: close\r\n\r\n");
+    _client.stop();
+    return;
+  }
+
+  ESP_LOGI(TAG, "Serving %s to %s\n", _asset_name.c_str(), _client.remoteIP().toString().c_str());
+  _client.printf("HTTP/1.1 200 OK\r\n"
+                 "Content-Type: application/octet-stream\r\n"
+                 "Content-Length: %u\r\n"
+                 "Connection: close\r\n\r\n",
+                 _image_size);
+  _serving = true;
+  _offset = 0;
+}
+
+// Sends one chunk per call so serving a neighbour never stalls the application
+void OtaPeer::serve_client()
+{
+  const char *TAG = "OtaPeer::serve_client";
+
+  if (_offset >= _image_size)
+  {
+    _client.stop();
+    return;
+  }
+
+  // Request headers nobody reads
+  while (_client.available())
+    _client.read();
+
+  uint32_t buffer[PEER_CHUNK_SIZE / sizeof(uint32_t)];
+  size_t len = std::min((size_t)PEER_CHUNK_SIZE, _image_size - _offset);
+  if (!read_image(_offset, (uint8_t *)buffer, len))
+  {
+    ESP_LOGE(TAG, "Flash read failed at %u\n", _offset);
+    _client.stop();
+    return;
+  }
+
+  size_t sent = _client.write((const uint8_t *)buffer, len);
+  if (sent == 0)
+  {
+    _client.stop();
+    return;
+  }
+  _offset += sent;
+}
+
+bool OtaPeer::read_image(size_t offset, uint8_t *buffer, size_t len)
+{
+#ifdef ESP32
+  return esp_partition_read(esp_ota_get_running_partition(), offset, buffer, len) == ESP_OK;
+#else
+  return false;
+#endif
+}
+
+bool OtaPeer::discover(semver_t version, String asset_name, IPAddress &peer_ip, unsigned long timeout_ms)
+{
+  const char *TAG = "OtaPeer::discover";
+
+  String wanted = to_string(version).c_str();
+  WiFiUDP udp;
+  udp.begin(0);
+  udp.beginPacket(WiFi.broadcastIP(), _port);
+  udp.printf(PEER_QUERY " %s %s", asset_name.c_str(), wanted.c_str());
+  udp.endPacket();
+
+  bool found = false;
+  unsigned long start = millis();
+  while (!found && millis() - start < timeout_ms)
+  {
+    if (udp.parsePacket() <= 0)
+    {
+      delay(5);
+      continue;
+    }
+
+    char packet[96];
+    int len = udp.read(packet, sizeof(packet) - 1);
+    if (len <= 0)
+      continue;
+    packet[len] = '\0';
+
+    char asset[48], answered[40];
+    unsigned port;
+    if (sscanf(packet, PEER_ANSWER " %47s %39s %u", asset, answered, &port) != 3)
+      continue;
+    if (asset_name != asset || wanted != answered || port != _port)
+      continue;
+
+    peer_ip = udp.remoteIP();
+    found = true;
+  }
+  udp.stop();
+
+  ESP_LOGI(TAG, "Peer with %s %s: %s\n", asset_name.c_str(), wanted.c_str(),
+           found ? peer_ip.toString().c_str() : "none");
+  return found;
+}
+
+bool OtaPeer::download(OtaTransport &transport, IPAddress peer_ip, const release_asset_t &asset, update_control_t *control)
+{
+  const char *TAG = "OtaPeer::download";
+
+  if (!asset.has_digest)
+  {
+    ESP_LOGE(TAG, "No published digest for %s, refusing peer image\n", asset.name.c_str());
+    return false;
+  }
+
+  String url = "http://" + peer_ip.toString() + ":" + String(_port) + "/" + asset.name;
+  ESP_LOGI(TAG, "Download URL: %s\n", url.c_str());
+
+  // A single stream, the peer serves one client at a time and no ranges
+  OtaHttp http(transport);
+  bool ok = false;
+  int httpCode = http.get(url);
+  if (httpCode != HTTP_CODE_OK)
+  {
+    ESP_LOGE(TAG, "[HTTP] GET... failed, code: %d\n", httpCode);
+  }
+  else if (http.size() != asset.size)
+  {
+    ESP_LOGE(TAG, "Peer image size %d differs from release asset %d\n", http.size(), asset.size);
+  }
+  else
+  {
+    ok = update_from_stream(http.stream(), asset.size, asset.sha256, U_FLASH, control);
+  }
+
+  http.end();
+  return ok;
+}
@@ -0,0 +1,72 @@
+#ifndef GITHUBOTA_PEER_H
+#define GITHUBOTA_PEER_H
+
+#ifdef ESP8266
+#include <ESP8266WiFi.h>
+#elif defined(ESP32)
+#include <WiFi.h>
+#endif
+#include <WiFiUdp.h>
+
+#include "semver.h"
+#include "common.h"
+#include "transport.h"
+
+// UDP discovery and plain HTTP serving share the same port number
+#define GITHUBOTA_PEER_PORT 47300
+// A client that does not send its request line within this time is dropped
+#ifndef GITHUBOTA_PEER_REQUEST_TIMEOUT_MS
+#define GITHUBOTA_PEER_REQUEST_TIMEOUT_MS 200
+#endif
+#define PEER_REQUEST_SIZE 128
+
+// Opt-in LAN distribution of the running firmware image.
+//
+// Discovery is a UDP broadcast "GHOTA? <asset> <version>" answered by every peer
+// that runs exactly that version with "GHOTA! <asset> <version> <port>". The image
+// is then fetched from http://<peer>:<port>/<asset>. Peers are never trusted: the
+// downloaded image must match the SHA-256 digest published on GitHub.
+//
+// Serving needs the running image as published, which only the ESP32 keeps. On
+// ESP8266 the Updater and eboot rewrite the flash mode and size bytes of the
+// image header when it is installed, so begin() refuses to serve there.
+class OtaPeer
+{
+public:
+  OtaPeer(uint16_t port = GITHUBOTA_PEER_PORT);
+
+  // Start answering discovery queries and serving the running image (ESP32)
+  void begin(semver_t version, String asset_name);
+  // Non-blocking, call from loop()
+  void handle();
+
+  bool discover(semver_t version, String asset_name, IPAddress &peer_ip, unsigned long timeout_ms = 500);
+  // Fetched through `transport`, so the connection pool and the download
+  // controls (rate limit, idle-only, pause) apply as for GitHub
+  bool download(OtaTransport &transport, IPAddress peer_ip, const release_asset_t &asset, update_control_t *control = nullptr);
+
+private:
+  void answer_query();
+  void accept_client();
+  void read_request();
+  void respond();
+  void serve_client();
+  bool read_image(size_t offset, uint8_t *buffer, size_t len);
+
+  uint16_t _port;
+  bool _running;
+  semver_t _version;
+  String _asset_name;
+  WiFiUDP _udp;
+  WiFiServer _server;
+  WiFiClient _client;
+  // Request line collected over several handle() calls
+  char _request[PEER_REQUEST_SIZE];
+  size_t _request_len;
+  unsigned long _accepted_at;
+  bool _serving;
+  size_t _offset;
+  size_t _image_size;
+};
+
+#endif
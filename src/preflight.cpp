@@ -0,0 +1,89 @@
+#include <Arduino.h>
+
+#include "preflight.h"
+#include "partition_writer.h"
+
+static const char *chip_name()
+{
+#ifdef ESP8266
+  return "ESP8266";
+#elif defined(ESP32)
+  return ESP.getChipModel();
+#endif
+}
+
+static uint32_t parse_size(const char *value)
+{
+  char *suffix;
+  uint32_t size = strtoul(value, &suffix, 10);
+  if (*suffix == 'K' || *suffix == 'k')
+    size *= 1024;
+  else if (*suffix == 'M' || *suffix == 'm')
+    size *= 1024 * 1024;
+  return size;
+}
+
+static bool check_requirement(const char *key, const char *value, String &reason)
+{
+  if (strcasecmp(key, "chip") == 0 && strcasecmp(value, chip_name()) != 0)
+  {
+    reason = String("built for ") + value + ", this is " + chip_name();
+    return false;
+  }
+
+  if (strcasecmp(key, "flash") == 0)
+  {
+#ifdef ESP8266
+    uint32_t flash = ESP.getFlashChipRealSize();
+#elif defined(ESP32)
+    uint32_t flash = ESP.getFlashChipSize();
+#endif
+    if (flash < parse_size(value))
+    {
+      reason = String("needs ") + value + " of flash, this has " + String(flash);
+      return false;
+    }
+  }
+
+#ifdef ESP32
+  if (strcasecmp(key, "revision") == 0 && ESP.getChipRevision() < atoi(value))
+  {
+    reason = String("needs chip revision ") + value + ", this is " + String(ESP.getChipRevision());
+    return false;
+  }
+#elif defined(ESP8266)
+  if (strcasecmp(key, "bootloader") == 0 && ESP.getBootVersion() < atoi(value))
+  {
+    reason = String("needs boot version ") + value + ", this is " + String(ESP.getBootVersion());
+    return false;
+  }
+#endif
+  return true;
+}
+
+bool preflight_check(const release_asset_t &asset, int command, String &reason, const char *partition)
+{
+  size_t capacity = PartitionWriter::capacity(command, partition);
+  if (asset.size > 0 && (size_t)asset.size > capacity)
+  {
+    reason = "image of " + String(asset.size) + " bytes does not fit into " + String(capacity) + " bytes";
+    return false;
+  }
+
+  // key=value pairs separated by spaces, commas or semicolons
+  char label[128];
+  strncpy(label, asset.label.c_str(), sizeof(label) - 1);
+  label[sizeof(label) - 1] = '\0';
+
+  char *saveptr;
+  for (char *pair = strtok_r(label, " ,;", &saveptr); pair; pair = strtok_r(nullptr, " ,;", &saveptr))
+  {
+    char *value = strchr(pair, '=');
+    if (!value)
+      continue;
+    *value++ = '\0';
+    if (!check_requirement(pair, value, reason))
+      return false;
+  }
+  return true;
+}
@@ -0,0 +1,22 @@
+#ifndef GITHUBOTA_PREFLIGHT_H
+#define GITHUBOTA_PREFLIGHT_H
+
+#include <Arduino.h>
+
+#include "common.h"
+
+// Checks a release asset against this device before any connection to the
+// download host is opened: the size from the release metadata against the
+// target partition, and the requirements declared in the asset's label, e.g.
+//
+//   chip=ESP32-S3 flash=8M revision=3
+//   chip=ESP8266 flash=1M bootloader=31
+//
+// `chip` is matched case-insensitively, `flash` (bytes, K or M suffix) is the
+// minimum flash size, `revision` the minimum ESP32 chip revision and
+// `bootloader` the minimum ESP8266 boot version. Unknown keys are ignored, an
+// asset without size or label passes. `partition` names the target data
+// partition when it is not the default one (ESP32).
+bool preflight_check(const release_asset_t &asset, int command, String &reason, const char *partition = nullptr);
+
+#endif
@@ -0,0 +1,117 @@
+#include <Arduino.h>
+
+#include "release_url.h"
+
+// Copies the path segment at `p` up to the next '/' (or the end when `last`)
+// into `out`, returns the position after the segment or nullptr
+static const char *copy_segment(const char *p, char *out, size_t size, bool last)
+{
+  size_t len = last ? strlen(p) : strcspn(p, "/");
+  if (last)
+  {
+    while (len > 0 && p[len - 1] == '/')
+      len--;
+  }
+  if (len == 0 || len >= size)
+    return nullptr;
+
+  memcpy(out, p, len);
+  out[len] = '\0';
+  p += len;
+  return *p == '/' ? p + 1 : p;
+}
+
+static const char *skip_prefix(const char *p, const char *prefix)
+{
+  size_t len = strlen(prefix);
+  return strncmp(p, prefix, len) == 0 ? p + len : nullptr;
+}
+
+// Skips scheme and host, relative paths start right at the owner
+static const char *skip_host(const char *url)
+{
+  const char *p = strstr(url, "://");
+  p = p ? strchr(p + 3, '/') : url;
+  if (p && *p == '/')
+    p++;
+  return p;
+}
+
+bool parse_release_url(const char *url, release_ref_t &ref)
+{
+  if (!url)
+    return false;
+
+  const char *p = skip_host(url);
+  if (!p)
+    return false;
+
+  p = copy_segment(p, ref.owner, sizeof(ref.owner), false);
+  if (p)
+    p = copy_segment(p, ref.repo, sizeof(ref.repo), false);
+  if (p)
+    p = skip_prefix(p, "releases/");
+  if (p)
+  {
+    const char *tag = skip_prefix(p, "tag/");
+    p = tag ? tag : skip_prefix(p, "download/");
+  }
+  // Tags may contain '/', so the tag is the rest of the URL
+  return p && copy_segment(p, ref.tag, sizeof(ref.tag), true);
+}
+
+bool parse_repo_url(const char *url, release_ref_t &ref)
+{
+  if (!url)
+    return false;
+
+  const char *p = skip_host(url);
+  if (!p)
+    return false;
+  const char *api = skip_prefix(p, "repos/");
+  if (api)
+    p = api;
+
+  ref.tag[0] = '\0';
+  p = copy_segment(p, ref.owner, sizeof(ref.owner), false);
+  return p && copy_segment(p, ref.repo, sizeof(ref.repo), strchr(p, '/') == nullptr);
+}
+
+// Plain copies, snprintf() costs more than the parsing on every check
+bool build_download_url(const release_ref_t &ref, const char *asset, char *out, size_t size)
+{
+  const char *parts[] = {"https://github.com/", ref.owner, "/", ref.repo, "/releases/download/",
+                         ref.tag, "/", asset ? asset : ""};
+  size_t len = 0;
+  for (const char *part : parts)
+  {
+    size_t n = strlen(part);
+    if (len + n >= size)
+      return false;
+    memcpy(out + len, part, n);
+    len += n;
+  }
+  out[len] = '\0';
+  return true;
+}
+
+const char *tag_version(const char *tag)
+{
+  // The version starts at the first "<digits>." sequence
+  for (const char *p = tag; *p; p++)
+  {
+    if (!isdigit((unsigned char)*p) || (p > tag && isdigit((unsigned char)p[-1])))
+      continue;
+
+    const char *q = p;
+    while (isdigit((unsigned char)*q))
+      q++;
+    if (*q == '.')
+      return p;
+  }
+
+  // Plain number or no digits at all
+  while (*tag && !isdigit((unsigned char)*tag))
+    tag++;
+  return tag;
+}
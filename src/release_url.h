@@ -0,0 +1,38 @@
+#ifndef GITHUBOTA_RELEASE_URL_H
+#define GITHUBOTA_RELEASE_URL_H
+
+#include <Arduino.h>
+
+// GitHub limits owner names to 39 and repository names to 100 characters
+#define RELEASE_OWNER_SIZE 40
+#define RELEASE_REPO_SIZE 101
+#define RELEASE_TAG_SIZE 64
+// Buffer size for URLs built by build_download_url()
+#define RELEASE_URL_SIZE 256
+
+struct release_ref_t
+{
+  char owner[RELEASE_OWNER_SIZE];
+  char repo[RELEASE_REPO_SIZE];
+  char tag[RELEASE_TAG_SIZE];
+};
+
+// Extracts owner, repo and tag from a release page or download URL
+// (https://github.com/<owner>/<repo>/releases/{tag,download}/<tag>[/]),
+// as found in the API's html_url or the /releases/latest redirect.
+// Works in place without allocating.
+bool parse_release_url(const char *url, release_ref_t &ref);
+
+// Extracts owner and repo from a repository or API URL
+// (https://api.github.com/repos/<owner>/<repo>/...,
+// https://github.com/<owner>/<repo>/...), leaving the tag empty
+bool parse_repo_url(const char *url, release_ref_t &ref);
+
+// Writes the download URL of `asset` into `out`, the release's base download
+// URL (ending in '/') for an empty asset name. False if `out` is too small.
+bool build_download_url(const release_ref_t &ref, const char *asset, char *out, size_t size);
+
+// Version part of a tag, skipping prefixes such as "v1.2.3" or "fw-1.2.3"
+const char *tag_version(const char *tag);
+
+#endif
@@ -0,0 +1,53 @@
+#include <Arduino.h>
+#include "rtc_cache.h"
+
+#define RTC_MAGIC 0x47484F54 // "GHOT"
+
+#ifdef ESP32
+RTC_DATA_ATTR static rtc_state_t rtc_state;
+#endif
+
+uint32_t ota_crc32(const uint8_t *data, size_t len, uint32_t crc)
+{
+  crc = ~crc;
+  while (len--)
+  {
+    crc ^= *data++;
+    for (int bit = 0; bit < 8; bit++)
+      crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+  }
+  return ~crc;
+}
+
+static uint32_t state_crc(const rtc_state_t &state)
+{
+  const uint8_t *payload = (const uint8_t *)&state + offsetof(rtc_state_t, clock_at_boot);
+  return ota_crc32(payload, sizeof(rtc_state_t) - offsetof(rtc_state_t, clock_at_boot));
+}
+
+bool rtc_load(rtc_state_t &state)
+{
+#ifdef ESP8266
+  if (!ESP.rtcUserMemoryRead(GITHUBOTA_RTC_OFFSET, (uint32_t *)&state, sizeof(state)))
+    return false;
+#elif defined(ESP32)
+  memcpy(&state, &rtc_state, sizeof(state));
+#endif
+
+  if (state.magic == RTC_MAGIC && state.crc == state_crc(state))
+    return true;
+
+  memset(&state, 0, sizeof(state));
+  return false;
+}
+
+void rtc_save(rtc_state_t &state)
+{
+  state.magic = RTC_MAGIC;
+  state.crc = state_crc(state);
+#ifdef ESP8266
+  ESP.rtcUserMemoryWrite(GITHUBOTA_RTC_OFFSET, (uint32_t *)&state, sizeof(state));
+#elif defined(ESP32)
+  memcpy(&rtc_state, &state, sizeof(state));
+#endif
+}
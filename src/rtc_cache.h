@@ -0,0 +1,56 @@
+#ifndef GITHUBOTA_RTC_CACHE_H
+#define GITHUBOTA_RTC_CACHE_H
+
+#include <Arduino.h>
+
+#ifdef ESP8266
+#include <ESP8266WiFi.h>
+#endif
+
+#include "release_url.h"
+
+// Offset into the ESP8266 RTC user memory, in 4 byte blocks. The first 32
+// blocks hold the eboot command an OTA update leaves for the bootloader
+#ifndef GITHUBOTA_RTC_OFFSET
+#define GITHUBOTA_RTC_OFFSET 32
+#endif
+
+// Re-synchronize with NTP at least this often, in between the clock is carried
+// across deep sleep in RTC memory
+#ifndef GITHUBOTA_NTP_INTERVAL_S
+#define GITHUBOTA_NTP_INTERVAL_S 86400
+#endif
+
+// Release check state kept in RTC memory across deep sleep, so a wake cycle can
+// decide there is nothing to do without touching the radio
+struct rtc_state_t
+{
+  uint32_t magic;
+  uint32_t crc;
+  // Estimated unix time at boot, valid when the device went to sleep through
+  // prepare_sleep(); the ESP8266 loses its clock in deep sleep
+  uint32_t clock_at_boot;
+  uint32_t last_ntp;
+  uint32_t next_due;
+  uint32_t sleep_armed;
+  // Tag of the latest release, the repository is that of the release URL
+  char tag[RELEASE_TAG_SIZE];
+  char etag[64];
+#ifdef ESP8266
+  // BearSSL::Session, to resume the TLS session instead of a full handshake
+  uint32_t session[(sizeof(BearSSL::Session) + 3) / 4];
+#endif
+};
+
+#ifdef ESP8266
+static_assert(GITHUBOTA_RTC_OFFSET >= 32, "GITHUBOTA_RTC_OFFSET overlaps the eboot command");
+static_assert(GITHUBOTA_RTC_OFFSET * 4 + sizeof(rtc_state_t) <= 512, "rtc_state_t exceeds the RTC user memory");
+#endif
+
+// CRC-32 (IEEE), pass the previous result as `crc` to continue over several blocks
+uint32_t ota_crc32(const uint8_t *data, size_t len, uint32_t crc = 0);
+
+bool rtc_load(rtc_state_t &state);
+void rtc_save(rtc_state_t &state);
+
+#endif
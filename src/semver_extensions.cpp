@@ -5,6 +5,8 @@
 #include <vector>
 
 #include "semver.h"
+#include "semver_extensions.h"
+#include "arena.h"
 
 // #include "string_utils.h"
 
@@ -22,38 +24,45 @@ vector<string> split(const string &s, char delim) {
     return result;
 }
 
-semver_t from_string(string version){
-    auto numbers = split(version, '.');
-    auto major = atoi(numbers.at(0).c_str());
-    auto minor = atoi(numbers.at(1).c_str());
-    int patch;
-    char *prerelease_ptr = nullptr;
-
-    auto split_at = numbers.at(2).find('-');
-    if(split_at != string::npos){
-        patch = atoi(numbers.at(2).substr(0, split_at).c_str());
-        auto prerelease = numbers.at(2).substr(split_at + 1);
-        prerelease_ptr = (char*)malloc(prerelease.length());
-        prerelease.copy(prerelease_ptr, prerelease.length());
-    }else{
-        patch = atoi(numbers.at(2).c_str());
+// Parses "major.minor.patch[-prerelease][+build]", the prerelease is the only
+// allocation and comes from the update arena when one is active. Build
+// metadata does not take part in precedence and is dropped.
+semver_t from_string(const char *version){
+    semver_t ver = {0, 0, 0, 0, nullptr};
+    char *end = (char*)version;
+
+    ver.major = strtol(end, &end, 10);
+    if(*end == '.')
+        ver.minor = strtol(end + 1, &end, 10);
+    if(*end == '.')
+        ver.patch = strtol(end + 1, &end, 10);
+
+    if(*end == '-'){
+        size_t len = strcspn(end + 1, "+");
+        ver.prerelease = (char*)ota_malloc(len + 1);
+        if(ver.prerelease){
+            memcpy(ver.prerelease, end + 1, len);
+            ver.prerelease[len] = '\0';
+        }
     }
 
-    semver_t _ver = {
-        major, minor, patch,
-        0, prerelease_ptr
-    };
+    return ver;
+}
 
-    return _ver;
+void release_version(semver_t &sem){
+    ota_free(sem.prerelease);
+    sem.prerelease = nullptr;
 }
 
-// string to_string(semver_t* sem){
-//     char *str = (char*)calloc(255, sizeof(char));
-//     semver_render(sem, (char*)str);
-//     auto value = string((char*)str);
-//     free(str);
-//     return value;
-// }
+string to_string(const semver_t &sem){
+    char str[64];
+    if(sem.prerelease){
+        snprintf(str, sizeof(str), "%d.%d.%d-%s", sem.major, sem.minor, sem.patch, sem.prerelease);
+    }else{
+        snprintf(str, sizeof(str), "%d.%d.%d", sem.major, sem.minor, sem.patch);
+    }
+    return string(str);
+}
 
 bool operator>(const semver_t & x, const semver_t & y) {
     return semver_compare(x, y) > 0;
@@ -62,3 +71,117 @@ bool operator>(const semver_t & x, const semver_t & y) {
 // bool operator!=(const semver_t & x, const semver_t & y) {
 //     return semver_neq(x, y) == 1;
 // }
+
+#define SEMVER_KEY_NUMERIC 0x01
+#define SEMVER_KEY_ALPHANUMERIC 0x02
+#define SEMVER_KEY_RELEASE 0xFF
+#define SEMVER_KEY_TRUNCATED 0x01
+
+static void put_be32(uint8_t *out, int value) {
+    uint32_t v = value < 0 ? 0 : value;
+    out[0] = v >> 24;
+    out[1] = v >> 16;
+    out[2] = v >> 8;
+    out[3] = v;
+}
+
+// The key is zero padded, so a prerelease ranks below one that extends it with
+// more identifiers. The last byte flags a prerelease that did not fit.
+void semver_key(const semver_t &sem, semver_key_t &key) {
+    uint8_t *out = key.bytes;
+    const uint8_t *end = key.bytes + SEMVER_KEY_SIZE - 1;
+    memset(key.bytes, 0, SEMVER_KEY_SIZE);
+    put_be32(out, sem.major);
+    put_be32(out + 4, sem.minor);
+    put_be32(out + 8, sem.patch);
+    out += 12;
+
+    const char *pre = sem.prerelease;
+    if (!pre || !*pre) {
+        *out = SEMVER_KEY_RELEASE;
+        return;
+    }
+
+    bool truncated = false;
+    while (*pre && !truncated) {
+        size_t len = strcspn(pre, ".");
+        bool numeric = len > 0;
+        for (size_t i = 0; i < len; i++)
+            numeric = numeric && isdigit((unsigned char)pre[i]);
+
+        if (out + (numeric ? 2 : 1) > end) {
+            truncated = true;
+            break;
+        }
+        if (numeric) {
+            // SemVer forbids leading zeros, so the longer number is the larger
+            *out++ = SEMVER_KEY_NUMERIC;
+            *out++ = len > 0xFF ? 0xFF : len;
+        } else {
+            *out++ = SEMVER_KEY_ALPHANUMERIC;
+        }
+        size_t copy = std::min(len, (size_t)(end - out));
+        memcpy(out, pre, copy);
+        out += copy;
+        truncated = copy < len;
+        // Alphanumeric identifiers end with a zero, below any identifier
+        // character; at the cut the zero flag byte ends them
+        if (!numeric && out < end)
+            *out++ = 0;
+
+        pre += len;
+        if (*pre == '.')
+            pre++;
+    }
+    if (truncated)
+        key.bytes[SEMVER_KEY_SIZE - 1] = SEMVER_KEY_TRUNCATED;
+}
+
+bool semver_key_truncated(const semver_key_t &key) {
+    return key.bytes[SEMVER_KEY_SIZE - 1] == SEMVER_KEY_TRUNCATED;
+}
+
+int semver_key_compare(const semver_key_t &x, const semver_key_t &y) {
+    return memcmp(x.bytes, y.bytes, SEMVER_KEY_SIZE);
+}
+
+int semver_key_compare(const semver_key_t &x, const char *x_version, const semver_key_t &y, const char *y_version) {
+    int res = memcmp(x.bytes, y.bytes, SEMVER_KEY_SIZE - 1);
+    if (res != 0 || !(semver_key_truncated(x) || semver_key_truncated(y)))
+        return res ? res : semver_key_compare(x, y);
+    if (!x_version || !y_version)
+        return semver_key_compare(x, y);
+
+    // Equal up to the cut, only the versions themselves can tell
+    semver_t a = from_string(x_version);
+    semver_t b = from_string(y_version);
+    res = semver_compare(a, b);
+    release_version(b);
+    release_version(a);
+    return res;
+}
+
+static const char *version_at(const char *const *versions, size_t i) {
+    return versions ? versions[i] : nullptr;
+}
+
+int semver_key_max(const semver_key_t *keys, size_t count, const char *const *versions) {
+    int best = count ? 0 : -1;
+    for (size_t i = 1; i < count; i++) {
+        if (semver_key_compare(keys[i], version_at(versions, i), keys[best], version_at(versions, best)) > 0)
+            best = i;
+    }
+    return best;
+}
+
+// Insertion sort, release lists are short and mostly ordered already
+void semver_key_rank(const semver_key_t *keys, uint16_t *order, size_t count, const char *const *versions) {
+    for (size_t i = 0; i < count; i++) {
+        uint16_t index = i;
+        size_t j = i;
+        for (; j > 0 && semver_key_compare(keys[order[j - 1]], version_at(versions, order[j - 1]),
+                                           keys[index], version_at(versions, index)) < 0; j--)
+            order[j] = order[j - 1];
+        order[j] = index;
+    }
+}
@@ -1,13 +1,50 @@
 #ifndef SEMVER_EXTENSIONS_H
 #define SEMVER_EXTENSIONS_H
 
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
 #include "semver.h"
 
-semver_t from_string(std::string version);
-// std::string to_string(semver_t* sem);
+semver_t from_string(const char *version);
+inline semver_t from_string(const std::string &version) { return from_string(version.c_str()); }
+// Frees a version returned by from_string()
+void release_version(semver_t &sem);
+std::string to_string(const semver_t &sem);
 std::vector<std::string> split(const std::string &s, char delim);
 
 bool operator>(const semver_t & x, const semver_t & y);
+
+// Fixed width sort key whose byte order (memcmp) is SemVer 2.0 precedence:
+// major, minor and patch big endian, then the prerelease identifiers, numeric
+// ones as length + digits below alphanumeric ones, and 0xFF for a release so it
+// ranks above its prereleases. Build metadata is ignored, as in precedence.
+//
+// The prerelease gets SEMVER_KEY_SIZE - 13 bytes, the last byte flags one
+// that did not fit (semver_key_truncated()). Keys equal up to such a cut are
+// ordered by a full semver_compare() of the versions when they are given to
+// the comparisons below, otherwise they compare equal.
+#ifndef SEMVER_KEY_SIZE
+#define SEMVER_KEY_SIZE 24
+#endif
+
+typedef struct
+{
+  uint8_t bytes[SEMVER_KEY_SIZE];
+} semver_key_t;
+
+void semver_key(const semver_t &sem, semver_key_t &key);
+bool semver_key_truncated(const semver_key_t &key);
+int semver_key_compare(const semver_key_t &x, const semver_key_t &y);
+// With the version strings behind the keys, for truncated prereleases
+int semver_key_compare(const semver_key_t &x, const char *x_version, const semver_key_t &y, const char *y_version);
+// Index of the highest version, or -1 when `count` is 0. `versions` holds the
+// version string of every key, or is null.
+int semver_key_max(const semver_key_t *keys, size_t count, const char *const *versions = nullptr);
+// Fills `order` with the indexes of `keys`, highest version first
+void semver_key_rank(const semver_key_t *keys, uint16_t *order, size_t count, const char *const *versions = nullptr);
 // bool operator!=(const semver_t & x, const semver_t & y);
 
 #endif
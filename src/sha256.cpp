@@ -0,0 +1,76 @@
+#include <Arduino.h>
+#include "sha256.h"
+
+Sha256::Sha256()
+{
+#ifdef ESP32
+  mbedtls_sha256_init(&_ctx);
+#endif
+  begin();
+}
+
+Sha256::~Sha256()
+{
+#ifdef ESP32
+  mbedtls_sha256_free(&_ctx);
+#endif
+}
+
+void Sha256::begin()
+{
+#ifdef ESP8266
+  br_sha256_init(&_ctx);
+#elif defined(ESP32)
+  mbedtls_sha256_starts(&_ctx, 0);
+#endif
+}
+
+void Sha256::update(const uint8_t *data, size_t len)
+{
+#ifdef ESP8266
+  br_sha256_update(&_ctx, data, len);
+#elif defined(ESP32)
+  mbedtls_sha256_update(&_ctx, data, len);
+#endif
+}
+
+void Sha256::finish(uint8_t digest[SHA256_DIGEST_SIZE])
+{
+#ifdef ESP8266
+  br_sha256_out(&_ctx, digest);
+#elif defined(ESP32)
+  mbedtls_sha256_finish(&_ctx, digest);
+#endif
+}
+
+static int hex_value(char c)
+{
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+bool parse_sha256_digest(const char *digest, uint8_t out[SHA256_DIGEST_SIZE])
+{
+  if (digest == nullptr || strncmp(digest, "sha256:", 7) != 0)
+    return false;
+
+  return parse_hex_digest(digest + 7, out);
+}
+
+bool parse_hex_digest(const char *hex, uint8_t out[SHA256_DIGEST_SIZE])
+{
+  if (hex == nullptr || strlen(hex) != SHA256_DIGEST_SIZE * 2)
+    return false;
+
+  for (int i = 0; i < SHA256_DIGEST_SIZE; i++)
+  {
+    int hi = hex_value(hex[2 * i]);
+    int lo = hex_value(hex[2 * i + 1]);
+    if (hi < 0 || lo < 0)
+      return false;
+    out[i] = (hi << 4) | lo;
+  }
+  return true;
+}
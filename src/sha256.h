@@ -0,0 +1,39 @@
+#ifndef GITHUBOTA_SHA256_H
+#define GITHUBOTA_SHA256_H
+
+#include <Arduino.h>
+
+#ifdef ESP8266
+#include <bearssl/bearssl_hash.h>
+#elif defined(ESP32)
+#include <mbedtls/sha256.h>
+#endif
+
+#define SHA256_DIGEST_SIZE 32
+
+// Thin wrapper over the SHA-256 implementation shipped with each core
+// (BearSSL on ESP8266, mbedTLS on ESP32)
+class Sha256
+{
+public:
+  Sha256();
+  ~Sha256();
+
+  void begin();
+  void update(const uint8_t *data, size_t len);
+  void finish(uint8_t digest[SHA256_DIGEST_SIZE]);
+
+private:
+#ifdef ESP8266
+  br_sha256_context _ctx;
+#elif defined(ESP32)
+  mbedtls_sha256_context _ctx;
+#endif
+};
+
+// Parses GitHub's "sha256:<64 hex chars>" asset digest notation
+bool parse_sha256_digest(const char *digest, uint8_t out[SHA256_DIGEST_SIZE]);
+// Parses a bare 64 character hex digest
+bool parse_hex_digest(const char *hex, uint8_t out[SHA256_DIGEST_SIZE]);
+
+#endif
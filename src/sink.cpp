@@ -0,0 +1,299 @@
+#include <Arduino.h>
+#include <FS.h>
+
+#include "sink.h"
+#include "arena.h"
+#include "common.h"
+#include "http.h"
+#include "sha256.h"
+#include "throttle.h"
+
+OtaSink::OtaSink()
+{
+  _block = nullptr;
+  _filled = 0;
+  _stalled_ms = 0;
+}
+
+OtaSink::~OtaSink()
+{
+  release();
+}
+
+uint8_t *OtaSink::reserve(size_t &len)
+{
+  if (!_block)
+  {
+    _block = (uint8_t *)ota_malloc(sector_size());
+    if (!_block)
+    {
+      ESP_LOGE("OtaSink::reserve", "Out of memory\n");
+      return nullptr;
+    }
+    _filled = 0;
+    _stalled_ms = 0;
+  }
+
+  len = std::min(len, sector_size() - _filled);
+  return _block + _filled;
+}
+
+bool OtaSink::commit(size_t len)
+{
+  _filled += len;
+  return _filled < sector_size() || flush();
+}
+
+// Blocks until the sink took the whole block; nothing is read from the socket
+// meanwhile
+bool OtaSink::flush()
+{
+  const char *TAG = "OtaSink::flush";
+
+  size_t done = 0;
+  unsigned long last_taken = millis();
+  while (done < _filled)
+  {
+    size_t taken = write(_block + done, _filled - done);
+    if (taken > 0)
+    {
+      done += taken;
+      last_taken = millis();
+      continue;
+    }
+    if (millis() - last_taken > GITHUBOTA_SINK_TIMEOUT_MS)
+    {
+      ESP_LOGE(TAG, "Sink took no data for %u ms\n", GITHUBOTA_SINK_TIMEOUT_MS);
+      return false;
+    }
+    delay(1);
+    _stalled_ms++;
+  }
+  _filled = 0;
+  return true;
+}
+
+bool OtaSink::end()
+{
+  bool ok = !_block || flush();
+  release();
+  if (!ok)
+  {
+    abort();
+    return false;
+  }
+  return finalize();
+}
+
+void OtaSink::cancel()
+{
+  release();
+  abort();
+}
+
+void OtaSink::release()
+{
+  ota_free(_block);
+  _block = nullptr;
+  _filled = 0;
+}
+
+// Writes exactly `size` bytes from `stream` into `sink`.
+// When `sha256` is given the final chunk is held back until the digest of the whole
+// image matches, so a corrupted or tampered image is never activated.
+// The data is read straight into the sink's block (the partition writer's sector
+// buffer), which is the only copy between the TLS layer and the device.
+bool update_from_stream(Stream &stream, size_t size, const uint8_t *sha256, OtaSink &sink, update_control_t *control)
+{
+  const char *TAG = "update_from_stream";
+
+  if (!sink.begin(size))
+    return false;
+  update_started();
+
+  Sha256 hash;
+  uint8_t digest[SHA256_DIGEST_SIZE];
+  size_t written = 0;
+  unsigned long started = millis();
+  unsigned long last_data = started;
+  TokenBucket bucket(control ? control->rate_limit : 0);
+  update_stats_t stats = {0, 0, 0, 0, 0};
+
+  while (written < size)
+  {
+    if (control && control->cancelled)
+    {
+      ESP_LOGI(TAG, "Cancelled after %u of %u bytes\n", written, size);
+      break;
+    }
+    if (control && control->paused)
+    {
+      delay(10);
+      last_data = millis();
+      continue;
+    }
+    if (control && control->idle_only && control->busy)
+    {
+      delay(10);
+      stats.throttled_ms += 10;
+      last_data = millis();
+      continue;
+    }
+
+    size_t available = stream.available();
+    if (available == 0)
+    {
+      if (millis() - last_data > HTTP_TIMEOUT_MS)
+      {
+        ESP_LOGE(TAG, "Stream timeout after %u of %u bytes\n", written, size);
+        break;
+      }
+      delay(1);
+      continue;
+    }
+
+    size_t chunk = available;
+    uint8_t *buffer = sink.reserve(chunk);
+    if (!buffer)
+    {
+      ESP_LOGE(TAG, "Write failed after %u bytes\n", written);
+      break;
+    }
+    size_t granted = bucket.acquire(chunk);
+    if (granted == 0)
+    {
+      unsigned long wait = std::max(bucket.wait_ms(chunk), 1UL);
+      delay(wait);
+      stats.throttled_ms += wait;
+      last_data = millis();
+      continue;
+    }
+
+    size_t len = stream.readBytes(buffer, granted);
+    if (len == 0)
+      continue;
+    last_data = millis();
+
+    if (sha256)
+    {
+      hash.update(buffer, len);
+      if (written + len == size)
+      {
+        hash.finish(digest);
+        if (memcmp(digest, sha256, SHA256_DIGEST_SIZE) != 0)
+        {
+          ESP_LOGE(TAG, "SHA-256 mismatch, discarding image\n");
+          break;
+        }
+      }
+    }
+
+    if (!sink.commit(len))
+    {
+      ESP_LOGE(TAG, "Write failed after %u bytes\n", written);
+      break;
+    }
+    written += len;
+    stats.elapsed_ms = millis() - started;
+    stats.bytes_per_sec = stats.elapsed_ms ? (uint64_t)written * 1000 / stats.elapsed_ms : 0;
+    stats.sectors_written = sink.sectors_written();
+    stats.sectors_skipped = sink.sectors_skipped();
+    if (control && control->progress)
+      control->progress(control->ctx, written, size, stats);
+  }
+
+  ESP_LOGI(TAG, "%u bytes in %u ms (%u B/s), throttled for %u ms, waited %u ms for the sink\n",
+           written, stats.elapsed_ms, stats.bytes_per_sec, stats.throttled_ms, sink.stalled_ms());
+
+  // An unfinished image is discarded and the boot partition left untouched
+  if (written != size)
+  {
+    sink.cancel();
+    update_error(-1);
+    return false;
+  }
+  if (!sink.end())
+  {
+    update_error(-1);
+    return false;
+  }
+
+  update_finished();
+  return true;
+}
+
+void update_started()
+{
+  ESP_LOGI("update_started", "HTTP update process started\n");
+}
+
+void update_finished()
+{
+  ESP_LOGI("update_finished", "HTTP update process finished\n");
+}
+
+void update_error(int err)
+{
+  ESP_LOGI("update_error", "HTTP update fatal error code %d\n", err);
+}
+
+FileSink::FileSink(fs::FS &fs, const char *path) : _fs(fs)
+{
+  _path = path;
+}
+
+bool FileSink::begin(size_t size)
+{
+  const char *TAG = "FileSink::begin";
+
+  // The previous version stays until the new one is complete, so the whole
+  // image has to fit next to it. fs::FS on ESP32 does not report free space,
+  // there a full filesystem fails the write instead.
+#ifdef ESP8266
+  FSInfo info;
+  if (size > 0 && _fs.info(info) && size > info.totalBytes - info.usedBytes)
+  {
+    ESP_LOGE(TAG, "%u bytes do not fit, %u free\n", size, info.totalBytes - info.usedBytes);
+    return false;
+  }
+#else
+  (void)size;
+#endif
+
+  String tmp_path = _path + ".tmp";
+  _file = _fs.open(tmp_path, "w");
+  if (!_file)
+  {
+    ESP_LOGE(TAG, "Unable to create %s\n", tmp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+size_t FileSink::write(const uint8_t *data, size_t len)
+{
+  return _file.write(data, len);
+}
+
+bool FileSink::finalize()
+{
+  String tmp_path = _path + ".tmp";
+  _file.close();
+  bool ok = _fs.rename(tmp_path, _path);
+  // FAT (SD cards) does not rename over an existing file
+  if (!ok && _fs.exists(_path))
+    ok = _fs.remove(_path) && _fs.rename(tmp_path, _path);
+  if (!ok)
+  {
+    ESP_LOGE("FileSink::finalize", "Unable to write %s\n", _path.c_str());
+    _fs.remove(tmp_path);
+    return false;
+  }
+  return true;
+}
+
+void FileSink::abort()
+{
+  _file.close();
+  _fs.remove(_path + ".tmp");
+}
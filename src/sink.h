@@ -0,0 +1,82 @@
+#ifndef GITHUBOTA_SINK_H
+#define GITHUBOTA_SINK_H
+
+#include <Arduino.h>
+#include <FS.h>
+
+#define SINK_SECTOR_SIZE 4096
+
+// A sink that takes nothing for this long fails the download
+#ifndef GITHUBOTA_SINK_TIMEOUT_MS
+#define GITHUBOTA_SINK_TIMEOUT_MS 10000
+#endif
+
+// Destination of a downloaded image: the ESP's own partitions (PartitionWriter),
+// the bootloader of an attached MCU over UART or SPI, an external SPI NOR, a
+// file on SD card...
+//
+// Subclasses implement begin(), write(), finalize() and abort() and advertise
+// the block size the device is written in. The download reads into a block of
+// that size and hands it over whole, only the last block of the image is
+// shorter. write() may take less than it is given, or nothing while the device
+// is busy; the download then stops reading from the socket until the block is
+// taken, so a slow device throttles the sender through TCP flow control rather
+// than by buffering the image.
+class OtaSink
+{
+public:
+  OtaSink();
+  virtual ~OtaSink();
+
+  virtual bool begin(size_t size) = 0;
+  // Returns the number of bytes taken from `data`
+  virtual size_t write(const uint8_t *data, size_t len) = 0;
+  // Called once all bytes are written and, with a digest, verified
+  virtual bool finalize() = 0;
+  virtual void abort() = 0;
+  virtual size_t sector_size() const { return SINK_SECTOR_SIZE; }
+
+  // Used by the download: reserve() returns where the next bytes of the image
+  // go and trims `len` to the room left in the block, commit() takes the bytes
+  // filled in and writes the block out once it is full. end() writes the rest
+  // and finalizes, cancel() aborts.
+  virtual uint8_t *reserve(size_t &len);
+  virtual bool commit(size_t len);
+  bool end();
+  void cancel();
+
+  // Flash sectors programmed vs. left alone, for sinks that compare content
+  virtual uint32_t sectors_written() const { return 0; }
+  virtual uint32_t sectors_skipped() const { return 0; }
+  // Time the download waited for the sink to take data
+  uint32_t stalled_ms() const { return _stalled_ms; }
+
+private:
+  bool flush();
+  void release();
+
+  uint8_t *_block;
+  size_t _filled;
+  uint32_t _stalled_ms;
+};
+
+// Writes the image to a file, e.g. on SD card. The file is written under a
+// temporary name and renamed over `path` once complete, so an interrupted
+// download leaves the previous file in place (on FAT only until the rename).
+class FileSink : public OtaSink
+{
+public:
+  FileSink(fs::FS &fs, const char *path);
+
+  bool begin(size_t size) override;
+  size_t write(const uint8_t *data, size_t len) override;
+  bool finalize() override;
+  void abort() override;
+
+private:
+  fs::FS &_fs;
+  String _path;
+  File _file;
+};
+
+#endif
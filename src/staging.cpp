@@ -0,0 +1,166 @@
+#include <Arduino.h>
+
+#ifdef ESP8266
+#include <eboot_command.h>
+#elif defined(ESP32)
+#include <Preferences.h>
+#include <esp_ota_ops.h>
+#include <esp_partition.h>
+#endif
+
+#include "staging.h"
+#include "rtc_cache.h"
+#include "common.h"
+
+#define STAGED_MAGIC 0x47485354 // "GHST"
+#define STAGED_CHUNK 512
+
+#ifdef ESP8266
+#ifndef GITHUBOTA_STAGED_RTC_OFFSET
+#define GITHUBOTA_STAGED_RTC_OFFSET (GITHUBOTA_RTC_OFFSET + (sizeof(rtc_state_t) + 3) / 4)
+#endif
+static_assert(GITHUBOTA_STAGED_RTC_OFFSET * 4 + sizeof(staged_image_t) <= 512, "staged_image_t exceeds the RTC user memory");
+#elif defined(ESP32)
+#define STAGED_NAMESPACE "github-ota"
+#define STAGED_KEY "staged"
+#endif
+
+static uint32_t staged_crc(const staged_image_t &image)
+{
+  const uint8_t *payload = (const uint8_t *)&image + offsetof(staged_image_t, tag);
+  return ota_crc32(payload, sizeof(staged_image_t) - offsetof(staged_image_t, tag));
+}
+
+bool staged_load(staged_image_t &image)
+{
+  bool ok = false;
+#ifdef ESP8266
+  ok = ESP.rtcUserMemoryRead(GITHUBOTA_STAGED_RTC_OFFSET, (uint32_t *)&image, sizeof(image));
+#elif defined(ESP32)
+  Preferences prefs;
+  if (prefs.begin(STAGED_NAMESPACE, true))
+  {
+    ok = prefs.getBytes(STAGED_KEY, &image, sizeof(image)) == sizeof(image);
+    prefs.end();
+  }
+#endif
+
+  if (ok && image.magic == STAGED_MAGIC && image.crc == staged_crc(image))
+    return true;
+
+  memset(&image, 0, sizeof(image));
+  return false;
+}
+
+bool staged_save(staged_image_t &image)
+{
+  image.magic = STAGED_MAGIC;
+  image.crc = staged_crc(image);
+#ifdef ESP8266
+  return ESP.rtcUserMemoryWrite(GITHUBOTA_STAGED_RTC_OFFSET, (uint32_t *)&image, sizeof(image));
+#elif defined(ESP32)
+  Preferences prefs;
+  if (!prefs.begin(STAGED_NAMESPACE, false))
+    return false;
+
+  bool ok = prefs.putBytes(STAGED_KEY, &image, sizeof(image)) == sizeof(image);
+  prefs.end();
+  return ok;
+#endif
+}
+
+void staged_clear()
+{
+  staged_image_t image;
+  memset(&image, 0, sizeof(image));
+#ifdef ESP8266
+  ESP.rtcUserMemoryWrite(GITHUBOTA_STAGED_RTC_OFFSET, (uint32_t *)&image, sizeof(image));
+#elif defined(ESP32)
+  Preferences prefs;
+  if (!prefs.begin(STAGED_NAMESPACE, false))
+    return;
+
+  prefs.remove(STAGED_KEY);
+  prefs.end();
+#endif
+}
+
+static bool hash_staged(const staged_image_t &image, uint8_t *digest)
+{
+#ifdef ESP32
+  const esp_partition_t *partition = esp_ota_get_next_update_partition(nullptr);
+  if (!partition || image.size > partition->size)
+    return false;
+#endif
+
+  Sha256 hash;
+  uint32_t buffer[STAGED_CHUNK / sizeof(uint32_t)];
+  for (size_t offset = 0; offset < image.size; offset += STAGED_CHUNK)
+  {
+    size_t len = std::min((size_t)image.size - offset, (size_t)STAGED_CHUNK);
+#ifdef ESP8266
+    // flashRead() reads whole words, the tail of the image is padded
+    if (!ESP.flashRead(image.address + offset, buffer, (len + 3) & ~3))
+      return false;
+#elif defined(ESP32)
+    if (esp_partition_read(partition, offset, buffer, len) != ESP_OK)
+      return false;
+#endif
+    hash.update((const uint8_t *)buffer, len);
+  }
+  hash.finish(digest);
+  return true;
+}
+
+bool staged_hold(staged_image_t &image)
+{
+  const char *TAG = "staged_hold";
+
+#ifdef ESP8266
+  // The Updater armed eboot to copy the image on the next restart
+  eboot_command command;
+  if (!eboot_command_read(&command) || command.action != ACTION_COPY_RAW)
+  {
+    ESP_LOGE(TAG, "No staged image\n");
+    return false;
+  }
+  eboot_command_clear();
+  image.address = command.args[0];
+  image.size = command.args[2];
+#elif defined(ESP32)
+  if (esp_ota_set_boot_partition(esp_ota_get_running_partition()) != ESP_OK)
+  {
+    ESP_LOGE(TAG, "Unable to keep the running partition\n");
+    return false;
+  }
+  image.address = 0;
+#endif
+
+  return hash_staged(image, image.sha256);
+}
+
+bool staged_activate(const staged_image_t &image)
+{
+  const char *TAG = "staged_activate";
+
+  uint8_t digest[SHA256_DIGEST_SIZE];
+  if (!hash_staged(image, digest) || memcmp(digest, image.sha256, SHA256_DIGEST_SIZE) != 0)
+  {
+    ESP_LOGE(TAG, "Staged image %s is gone or damaged\n", image.tag);
+    return false;
+  }
+
+#ifdef ESP8266
+  eboot_command command;
+  memset(&command, 0, sizeof(command));
+  command.action = ACTION_COPY_RAW;
+  command.args[0] = image.address;
+  command.args[1] = 0x00000;
+  command.args[2] = image.size;
+  eboot_command_write(&command);
+  return true;
+#elif defined(ESP32)
+  // Validates the image before switching the boot partition
+  return esp_ota_set_boot_partition(esp_ota_get_next_update_partition(nullptr)) == ESP_OK;
+#endif
+}
@@ -0,0 +1,35 @@
+#ifndef GITHUBOTA_STAGING_H
+#define GITHUBOTA_STAGING_H
+
+#include <Arduino.h>
+
+#include "release_url.h"
+#include "sha256.h"
+
+// Firmware downloaded and verified by GitHubOTA::prefetch(), waiting in the
+// inactive partition for apply(). The record is kept in NVS on ESP32 and in
+// RTC memory after the RTC cache state on ESP8266, where it survives restarts
+// and deep sleep but not a power loss.
+struct staged_image_t
+{
+  uint32_t magic;
+  uint32_t crc;
+  char tag[RELEASE_TAG_SIZE];
+  uint32_t size;
+  // Digest of the image as it is in flash
+  uint8_t sha256[SHA256_DIGEST_SIZE];
+  // Flash address the Updater put the image at (ESP8266)
+  uint32_t address;
+};
+
+bool staged_load(staged_image_t &image);
+bool staged_save(staged_image_t &image);
+void staged_clear();
+
+// Undoes the activation of the firmware image that was just written, records
+// where it is and hashes it from flash. Call right after a successful update.
+bool staged_hold(staged_image_t &image);
+// Hashes the staged image again and makes it the boot image
+bool staged_activate(const staged_image_t &image);
+
+#endif
@@ -0,0 +1,53 @@
+#include <Arduino.h>
+#include "throttle.h"
+
+// Reads below this size cost more in per-call overhead than they save in airtime
+#define THROTTLE_MIN_GRANT 256
+
+TokenBucket::TokenBucket(uint32_t rate, uint32_t burst)
+{
+  set_rate(rate, burst);
+}
+
+void TokenBucket::set_rate(uint32_t rate, uint32_t burst)
+{
+  _rate = rate;
+  // Default burst: a quarter second worth of data, but at least one read
+  _burst = burst ? burst : std::max(rate / 4, (uint32_t)1024);
+  _millitokens = (uint64_t)_burst * 1000;
+  _last_refill = millis();
+}
+
+void TokenBucket::refill()
+{
+  unsigned long now = millis();
+  _millitokens += (uint64_t)_rate * (now - _last_refill);
+  _millitokens = std::min(_millitokens, (uint64_t)_burst * 1000);
+  _last_refill = now;
+}
+
+size_t TokenBucket::acquire(size_t wanted)
+{
+  if (!_rate)
+    return wanted;
+
+  refill();
+  size_t grant = std::min(wanted, (size_t)(_millitokens / 1000));
+  if (grant < std::min(wanted, (size_t)THROTTLE_MIN_GRANT))
+    return 0;
+
+  _millitokens -= (uint64_t)grant * 1000;
+  return grant;
+}
+
+unsigned long TokenBucket::wait_ms(size_t wanted)
+{
+  if (!_rate)
+    return 0;
+
+  refill();
+  uint64_t needed = (uint64_t)std::min(std::min(wanted, (size_t)THROTTLE_MIN_GRANT), (size_t)_burst) * 1000;
+  if (_millitokens >= needed)
+    return 0;
+  return (needed - _millitokens + _rate - 1) / _rate;
+}
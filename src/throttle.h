@@ -0,0 +1,31 @@
+#ifndef GITHUBOTA_THROTTLE_H
+#define GITHUBOTA_THROTTLE_H
+
+#include <Arduino.h>
+
+// Token bucket limiting a byte stream to `rate` bytes per second with bursts of
+// up to `burst` bytes. A rate of 0 disables the limit.
+class TokenBucket
+{
+public:
+  TokenBucket(uint32_t rate = 0, uint32_t burst = 0);
+
+  void set_rate(uint32_t rate, uint32_t burst = 0);
+  bool limited() const { return _rate > 0; }
+
+  // Number of the `wanted` bytes that may be transferred now, 0 means wait
+  size_t acquire(size_t wanted);
+  // Time until `wanted` bytes (capped at the burst size) become available
+  unsigned long wait_ms(size_t wanted);
+
+private:
+  void refill();
+
+  uint32_t _rate;
+  uint32_t _burst;
+  // Kept in thousandths of a byte so low rates refill smoothly every millisecond
+  uint64_t _millitokens;
+  unsigned long _last_refill;
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifdef ESP32
+#include <Preferences.h>
+
+#include "token_store.h"
+#include "common.h"
+
+#define TOKEN_NAMESPACE "github-ota"
+#define TOKEN_KEY "token"
+
+bool token_save(const String &token)
+{
+  Preferences prefs;
+  if (!prefs.begin(TOKEN_NAMESPACE, false))
+    return false;
+
+  bool ok = prefs.putString(TOKEN_KEY, token) == token.length();
+  prefs.end();
+  return ok;
+}
+
+bool token_load(String &token)
+{
+  const char *TAG = "token_load";
+
+  Preferences prefs;
+  if (!prefs.begin(TOKEN_NAMESPACE, true))
+  {
+    ESP_LOGV(TAG, "No token stored\n");
+    return false;
+  }
+
+  token = prefs.getString(TOKEN_KEY, "");
+  prefs.end();
+  return token.length() > 0;
+}
+
+void token_erase()
+{
+  Preferences prefs;
+  if (!prefs.begin(TOKEN_NAMESPACE, false))
+    return;
+
+  prefs.remove(TOKEN_KEY);
+  prefs.end();
+}
+#endif
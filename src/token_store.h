@@ -0,0 +1,15 @@
+#ifndef GITHUBOTA_TOKEN_STORE_H
+#define GITHUBOTA_TOKEN_STORE_H
+
+#include <Arduino.h>
+
+#ifdef ESP32
+// GitHub access token kept in NVS, so it is provisioned once instead of being
+// compiled into the firmware (and encrypted at rest when NVS encryption is
+// enabled). The ESP8266 has no NVS, pass the token to set_token() instead.
+bool token_save(const String &token);
+bool token_load(String &token);
+void token_erase();
+#endif
+
+#endif
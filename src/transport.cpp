@@ -0,0 +1,220 @@
+#ifdef ESP8266
+#include <ESP8266WiFi.h>
+#elif defined(ESP32)
+#include <WiFiClientSecure.h>
+#endif
+
+#include "transport.h"
+#include "common.h"
+#if defined(ESP8266) || defined(ESP32)
+#include "trust_store.h"
+#endif
+
+OtaTransport::OtaTransport()
+{
+  for (auto &entry : _pool)
+  {
+    entry.client = nullptr;
+    entry.port = 0;
+    entry.secure = false;
+    entry.in_use = false;
+    entry.idle_since = 0;
+  }
+  _ttl = GITHUBOTA_POOL_TTL_MS;
+  _last_reused = false;
+  _opened = 0;
+  _reused = 0;
+}
+
+void OtaTransport::set_keep_alive(unsigned long ttl_ms)
+{
+  _ttl = ttl_ms;
+  if (_ttl == 0)
+    close_idle();
+}
+
+Client *OtaTransport::connect(const String &host, uint16_t port, bool secure)
+{
+  const char *TAG = "OtaTransport::connect";
+  size_t count = std::min(slots(), (size_t)GITHUBOTA_POOL_SIZE);
+  unsigned long now = millis();
+
+  // Reuse a parked connection to the same host
+  for (size_t i = 0; i < count; i++)
+  {
+    auto &entry = _pool[i];
+    if (entry.in_use || !entry.client || entry.host != host || entry.port != port || entry.secure != secure)
+      continue;
+
+    if (now - entry.idle_since < _ttl && entry.client->connected())
+    {
+      entry.in_use = true;
+      _last_reused = true;
+      _reused++;
+      ESP_LOGV(TAG, "Reusing connection to %s:%u\n", host.c_str(), port);
+      return entry.client;
+    }
+  }
+
+  // Otherwise take a free slot, evicting the longest idle connection
+  int slot = -1;
+  for (size_t i = 0; i < count; i++)
+  {
+    auto &entry = _pool[i];
+    if (entry.in_use)
+      continue;
+    if (!entry.client)
+    {
+      slot = i;
+      break;
+    }
+    if (slot < 0 || entry.idle_since < _pool[slot].idle_since)
+      slot = i;
+  }
+  if (slot < 0)
+  {
+    ESP_LOGE(TAG, "No free connection slot for %s\n", host.c_str());
+    return nullptr;
+  }
+
+  auto &entry = _pool[slot];
+  if (entry.client)
+    entry.client->stop();
+  entry.client = nullptr;
+
+  Client *client = open(slot, host, port, secure);
+  if (!client)
+    return nullptr;
+
+  entry.client = client;
+  entry.host = host;
+  entry.port = port;
+  entry.secure = secure;
+  entry.in_use = true;
+  _last_reused = false;
+  _opened++;
+  return client;
+}
+
+void OtaTransport::release(Client *client, bool keep_alive)
+{
+  for (auto &entry : _pool)
+  {
+    if (entry.client != client)
+      continue;
+
+    entry.in_use = false;
+    entry.idle_since = millis();
+    if (!keep_alive || _ttl == 0)
+    {
+      client->stop();
+      entry.client = nullptr;
+    }
+    return;
+  }
+  client->stop();
+}
+
+void OtaTransport::close_idle()
+{
+  for (auto &entry : _pool)
+  {
+    if (entry.in_use || !entry.client)
+      continue;
+    entry.client->stop();
+    entry.client = nullptr;
+  }
+}
+
+#if defined(ESP8266) || defined(ESP32)
+WiFiSecureTransport::WiFiSecureTransport()
+{
+  _last_slot = 0;
+  for (size_t i = 0; i < GITHUBOTA_POOL_SIZE; i++)
+  {
+    TrustStore::shared().apply(_secure_clients[i]);
+#ifdef ESP8266
+    _secure_clients[i].setSession(&_sessions[i]);
+#endif
+  }
+}
+
+Client *WiFiSecureTransport::open(size_t slot, const String &host, uint16_t port, bool secure)
+{
+  const char *TAG = "WiFiSecureTransport::open";
+
+  if (!secure)
+    return _plain_clients[slot].connect(host.c_str(), port) ? &_plain_clients[slot] : nullptr;
+
+  _last_slot = slot;
+  auto &client = _secure_clients[slot];
+#ifdef ESP8266
+  bool mfln = client.probeMaxFragmentLength(host.c_str(), port, 1024);
+  ESP_LOGI(TAG, "MFLN supported by %s: %s\n", host.c_str(), mfln ? "yes" : "no");
+  if (mfln) { client.setBufferSizes(1024, 1024); }
+  else { client.setBufferSizes(16384, 512); }
+#endif
+
+  if (!client.connect(host.c_str(), port))
+  {
+    ESP_LOGE(TAG, "Unable to connect to %s:%u: %s\n", host.c_str(), port, last_error().c_str());
+    return nullptr;
+  }
+  if (!TrustStore::shared().verify(client))
+  {
+    client.stop();
+    return nullptr;
+  }
+  return &client;
+}
+
+String WiFiSecureTransport::last_error()
+{
+  auto &client = _secure_clients[_last_slot];
+  char errorText[128];
+#ifdef ESP8266
+  int errCode = client.getLastSSLError(errorText, sizeof(errorText));
+#elif defined(ESP32)
+  int errCode = client.lastError(errorText, sizeof(errorText));
+#endif
+  return errCode ? String(errCode) + ": " + errorText : "";
+}
+#endif
+
+ClientTransport::ClientTransport(Client &client, bool secure)
+{
+  _clients[0] = &client;
+  _count = 1;
+  _secure = secure;
+}
+
+bool ClientTransport::add_client(Client &client)
+{
+  if (_count >= GITHUBOTA_POOL_SIZE)
+  {
+    ESP_LOGE("ClientTransport::add_client", "Pool is full (GITHUBOTA_POOL_SIZE %u)\n", GITHUBOTA_POOL_SIZE);
+    return false;
+  }
+  _clients[_count++] = &client;
+  return true;
+}
+
+Client *ClientTransport::open(size_t slot, const String &host, uint16_t port, bool secure)
+{
+  const char *TAG = "ClientTransport::open";
+
+  if (secure != _secure)
+  {
+    ESP_LOGE(TAG, "%s to %s refused, the clients speak %s only\n",
+             secure ? "https" : "http", host.c_str(), _secure ? "https" : "http");
+    return nullptr;
+  }
+
+  Client *client = _clients[slot];
+  if (!client->connect(host.c_str(), port))
+  {
+    ESP_LOGE(TAG, "Unable to connect to %s:%u\n", host.c_str(), port);
+    return nullptr;
+  }
+  return client;
+}
@@ -0,0 +1,127 @@
+#ifndef GITHUBOTA_TRANSPORT_H
+#define GITHUBOTA_TRANSPORT_H
+
+#include <Arduino.h>
+#ifdef ESP8266
+#include <ESP8266WiFi.h>
+#elif defined(ESP32)
+#include <WiFiClientSecure.h>
+#endif
+
+// Every pooled TLS connection keeps its buffers allocated while idle, which the
+// ESP8266 heap can only afford once
+#ifndef GITHUBOTA_POOL_SIZE
+#ifdef ESP8266
+#define GITHUBOTA_POOL_SIZE 1
+#else
+#define GITHUBOTA_POOL_SIZE 3
+#endif
+#endif
+
+#ifndef GITHUBOTA_POOL_TTL_MS
+#define GITHUBOTA_POOL_TTL_MS 60000
+#endif
+
+// Source of connections for all updater traffic (release lookup and downloads).
+//
+// connect() hands out a connected client that stays owned by the transport and
+// must be given back with release(). Connections released with keep_alive set
+// are parked per host and handed out again if asked for the same host within
+// the TTL, saving the TCP and TLS setup of the API call, the redirect hop and
+// the asset fetch on every poll.
+class OtaTransport
+{
+public:
+  OtaTransport();
+  virtual ~OtaTransport() {}
+
+  Client *connect(const String &host, uint16_t port, bool secure);
+  void release(Client *client, bool keep_alive = false);
+  void close_idle();
+
+  void set_keep_alive(unsigned long ttl_ms);
+  bool last_connection_reused() const { return _last_reused; }
+  uint32_t connections_opened() const { return _opened; }
+  uint32_t connections_reused() const { return _reused; }
+
+  virtual String last_error() { return ""; }
+
+protected:
+  // Number of clients the subclass can hold open at the same time
+  virtual size_t slots() { return 1; }
+  virtual Client *open(size_t slot, const String &host, uint16_t port, bool secure) = 0;
+
+private:
+  struct pool_entry_t
+  {
+    Client *client;
+    String host;
+    uint16_t port;
+    bool secure;
+    bool in_use;
+    unsigned long idle_since;
+  };
+
+  pool_entry_t _pool[GITHUBOTA_POOL_SIZE];
+  unsigned long _ttl;
+  bool _last_reused;
+  uint32_t _opened;
+  uint32_t _reused;
+};
+
+#if defined(ESP8266) || defined(ESP32)
+// Default transport: WiFiClientSecure trusting the GitHub root certificate,
+// plain WiFiClient for http:// URLs
+class WiFiSecureTransport : public OtaTransport
+{
+public:
+  WiFiSecureTransport();
+
+  String last_error() override;
+
+#ifdef ESP8266
+  // TLS session of a slot, resumed on the next connection made through it
+  BearSSL::Session &session(size_t slot = 0) { return _sessions[slot]; }
+#endif
+
+protected:
+  size_t slots() override { return GITHUBOTA_POOL_SIZE; }
+  Client *open(size_t slot, const String &host, uint16_t port, bool secure) override;
+
+private:
+  WiFiClientSecure _secure_clients[GITHUBOTA_POOL_SIZE];
+  WiFiClient _plain_clients[GITHUBOTA_POOL_SIZE];
+  size_t _last_slot;
+#ifdef ESP8266
+  BearSSL::Session _sessions[GITHUBOTA_POOL_SIZE];
+#endif
+};
+#endif
+
+// Adapter for any Arduino Client: EthernetClient (W5500, ENC28J60), cellular
+// modem clients, SSLClient wrapping either of them, or an instrumented client.
+// All clients of a transport speak one scheme: `secure` ones do TLS themselves
+// and serve https URLs only, the others http URLs only; connections for the
+// other scheme are refused.
+//
+// Every client is one slot of the connection pool. With a single client each
+// change of host (API, then the CDN behind the asset redirect) reconnects it;
+// add_client() adds slots, so connections to both hosts stay open side by side.
+class ClientTransport : public OtaTransport
+{
+public:
+  ClientTransport(Client &client, bool secure = true);
+  // Another client of the same kind, up to GITHUBOTA_POOL_SIZE in total
+  bool add_client(Client &client);
+
+protected:
+  size_t slots() override { return _count; }
+  Client *open(size_t slot, const String &host, uint16_t port, bool secure) override;
+
+private:
+  Client *_clients[GITHUBOTA_POOL_SIZE];
+  size_t _count;
+  bool _secure;
+};
+
+#endif
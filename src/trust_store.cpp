@@ -0,0 +1,111 @@
+#include <Arduino.h>
+
+#ifdef ESP32
+#include <mbedtls/pk.h>
+#endif
+
+#include "trust_store.h"
+#include "trust_anchors.h"
+#include "common.h"
+
+// DER SubjectPublicKeyInfo of up to RSA 4096 bit keys
+#define SPKI_MAX_SIZE 600
+
+TrustStore &TrustStore::shared()
+{
+  static TrustStore store;
+  return store;
+}
+
+TrustStore::TrustStore()
+{
+#ifdef ESP8266
+  _anchors = nullptr;
+#endif
+  _pin_count = 0;
+}
+
+bool TrustStore::add_pin(const uint8_t spki_sha256[SHA256_DIGEST_SIZE])
+{
+  const char *TAG = "TrustStore::add_pin";
+#ifdef ESP8266
+  ESP_LOGE(TAG, "SPKI pins are not supported on ESP8266\n");
+  return false;
+#else
+  if (_pin_count >= GITHUBOTA_MAX_PINS)
+  {
+    ESP_LOGE(TAG, "No room for more than %u pins\n", GITHUBOTA_MAX_PINS);
+    return false;
+  }
+
+  memcpy(_pins[_pin_count++], spki_sha256, SHA256_DIGEST_SIZE);
+  return true;
+#endif
+}
+
+void TrustStore::clear_pins()
+{
+  _pin_count = 0;
+}
+
+void TrustStore::apply(WiFiClientSecure &client)
+{
+#ifdef ESP8266
+  if (!_anchors)
+  {
+    _anchors = new X509List();
+    // BearSSL parses byte by byte, which flash does not allow on ESP8266
+    for (auto &anchor : trust_anchors)
+    {
+      uint8_t *der = (uint8_t *)malloc(anchor.size);
+      if (!der)
+        continue;
+      memcpy_P(der, anchor.der, anchor.size);
+      _anchors->append(der, anchor.size);
+      free(der);
+    }
+  }
+  client.setTrustAnchors(_anchors);
+#elif defined(ESP32)
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+  client.setCACertBundle(trust_bundle, TRUST_BUNDLE_SIZE);
+#else
+  client.setCACertBundle(trust_bundle);
+#endif
+#endif
+}
+
+bool TrustStore::verify(WiFiClientSecure &client)
+{
+  const char *TAG = "TrustStore::verify";
+  if (!pinned())
+    return true;
+
+#ifdef ESP32
+  for (auto cert = client.getPeerCertificate(); cert; cert = cert->next)
+  {
+    // The raw key of the certificate is private in mbedTLS 3, the SPKI is
+    // written out again from the parsed key instead; it ends the buffer.
+    // mbedTLS 2 takes a non-const context.
+    uint8_t spki[SPKI_MAX_SIZE];
+    int len = mbedtls_pk_write_pubkey_der((mbedtls_pk_context *)&cert->pk, spki, sizeof(spki));
+    if (len <= 0)
+      continue;
+
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    Sha256 sha;
+    sha.begin();
+    sha.update(spki + sizeof(spki) - len, len);
+    sha.finish(digest);
+
+    for (size_t i = 0; i < _pin_count; i++)
+    {
+      if (memcmp(digest, _pins[i], SHA256_DIGEST_SIZE) == 0)
+        return true;
+    }
+  }
+#endif
+
+  ESP_LOGE(TAG, "No certificate matches a pinned key\n");
+  return false;
+}
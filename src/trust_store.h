@@ -0,0 +1,46 @@
+#ifndef GITHUBOTA_TRUST_STORE_H
+#define GITHUBOTA_TRUST_STORE_H
+
+#include <Arduino.h>
+
+#include <WiFiClientSecure.h>
+
+#include "sha256.h"
+
+#ifndef GITHUBOTA_MAX_PINS
+#define GITHUBOTA_MAX_PINS 4
+#endif
+
+// Root certificates trusted for GitHub traffic, shared by all updater
+// instances. The roots are compiled into trust_anchors.h by
+// tools/gen_trust_anchors.py, so rotating CAs is a data change.
+class TrustStore
+{
+public:
+  static TrustStore &shared();
+
+  // Pin mode: on top of the chain validation, require a certificate sent by
+  // the server whose SubjectPublicKeyInfo has this SHA-256 (printed by
+  // `gen_trust_anchors.py --spki`). ESP32 only, the ESP8266 core does not
+  // expose the peer certificates.
+  bool add_pin(const uint8_t spki_sha256[SHA256_DIGEST_SIZE]);
+  void clear_pins();
+  bool pinned() const { return _pin_count > 0; }
+
+  // Configures a client to validate against the store
+  void apply(WiFiClientSecure &client);
+  // Checks an established connection against the pins
+  bool verify(WiFiClientSecure &client);
+
+private:
+  TrustStore();
+
+#ifdef ESP8266
+  // Decoded from DER on first use, once for all clients
+  X509List *_anchors;
+#endif
+  uint8_t _pins[GITHUBOTA_MAX_PINS][SHA256_DIGEST_SIZE];
+  size_t _pin_count;
+};
+
+#endif
@@ -0,0 +1,345 @@
+#ifndef GITHUBOTA_HOST_ARDUINO_H
+#define GITHUBOTA_HOST_ARDUINO_H
+
+// Host stand-in for the parts of the Arduino core the library uses, so its
+// platform independent modules build and run natively (pio test -e native).
+// Time is simulated: delay() advances millis() instead of sleeping, so
+// timeouts and throttling run instantly and deterministically. Tests against
+// real sockets set host_real_time so polling loops wait for the peer.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+
+#define PROGMEM
+#define F(x) x
+#define LOW 0
+#define HIGH 1
+typedef uint8_t byte;
+
+// Update.h on the devices
+#define U_FLASH 0
+#define U_SPIFFS 100
+#define U_FILESYSTEM U_SPIFFS
+
+inline uint64_t host_now_us = 0;
+inline bool host_real_time = false;
+
+inline unsigned long millis() { return host_now_us / 1000; }
+inline unsigned long micros() { return host_now_us; }
+inline void delay(unsigned long ms)
+{
+  host_now_us += (uint64_t)ms * 1000;
+  if (host_real_time)
+    usleep(ms * 1000);
+}
+inline void delayMicroseconds(unsigned int us) { host_now_us += us; }
+inline void yield() {}
+// Lets a test account for time spent outside of delay(), e.g. a slow device
+inline void host_advance_us(uint64_t us) { host_now_us += us; }
+// The host clock is set already, there is no SNTP client to start
+inline void configTime(long, int, const char *, const char * = nullptr, const char * = nullptr) {}
+
+#ifdef GITHUBOTA_HOST_LOG
+#define GITHUBOTA_HOST_PRINTF(...) printf(__VA_ARGS__)
+#else
+#define GITHUBOTA_HOST_PRINTF(...) do { if (0) printf(__VA_ARGS__); } while (0)
+#endif
+#define ESP_LOGE(tag, ...) GITHUBOTA_HOST_PRINTF(__VA_ARGS__)
+#define ESP_LOGW(tag, ...) GITHUBOTA_HOST_PRINTF(__VA_ARGS__)
+#define ESP_LOGI(tag, ...) GITHUBOTA_HOST_PRINTF(__VA_ARGS__)
+#define ESP_LOGD(tag, ...) GITHUBOTA_HOST_PRINTF(__VA_ARGS__)
+#define ESP_LOGV(tag, ...) GITHUBOTA_HOST_PRINTF(__VA_ARGS__)
+
+class String
+{
+public:
+  String(const char *s = "") : _s(s ? s : "") {}
+  String(const std::string &s) : _s(s) {}
+  String(char c) : _s(1, c) {}
+  String(int v) : _s(std::to_string(v)) {}
+  String(unsigned v) : _s(std::to_string(v)) {}
+  String(long v) : _s(std::to_string(v)) {}
+  String(unsigned long v) : _s(std::to_string(v)) {}
+  String(long long v) : _s(std::to_string(v)) {}
+  String(unsigned long long v) : _s(std::to_string(v)) {}
+
+  const char *c_str() const { return _s.c_str(); }
+  unsigned int length() const { return _s.size(); }
+  bool isEmpty() const { return _s.empty(); }
+  bool reserve(unsigned int size)
+  {
+    _s.reserve(size);
+    return true;
+  }
+
+  bool concat(const String &s)
+  {
+    _s += s._s;
+    return true;
+  }
+  String &operator+=(const String &s)
+  {
+    _s += s._s;
+    return *this;
+  }
+  String &operator+=(const char *s)
+  {
+    _s += s;
+    return *this;
+  }
+  String &operator+=(char c)
+  {
+    _s += c;
+    return *this;
+  }
+
+  bool equals(const String &s) const { return _s == s._s; }
+  bool equalsIgnoreCase(const String &s) const
+  {
+    return _s.size() == s._s.size() && strncasecmp(_s.c_str(), s._s.c_str(), _s.size()) == 0;
+  }
+  bool operator==(const String &s) const { return _s == s._s; }
+  bool operator==(const char *s) const { return _s == (s ? s : ""); }
+  bool operator!=(const String &s) const { return _s != s._s; }
+  bool operator!=(const char *s) const { return !(*this == s); }
+  bool operator<(const String &s) const { return _s < s._s; }
+
+  char charAt(unsigned int i) const { return i < _s.size() ? _s[i] : 0; }
+  char operator[](unsigned int i) const { return charAt(i); }
+  void setCharAt(unsigned int i, char c)
+  {
+    if (i < _s.size())
+      _s[i] = c;
+  }
+
+  bool startsWith(const String &s) const { return _s.compare(0, s._s.size(), s._s) == 0; }
+  bool endsWith(const String &s) const
+  {
+    return _s.size() >= s._s.size() && _s.compare(_s.size() - s._s.size(), s._s.size(), s._s) == 0;
+  }
+  int indexOf(char c, unsigned int from = 0) const { return position(_s.find(c, from)); }
+  int indexOf(const String &s, unsigned int from = 0) const { return position(_s.find(s._s, from)); }
+  int lastIndexOf(char c) const { return position(_s.rfind(c)); }
+  int lastIndexOf(char c, unsigned int from) const { return position(_s.rfind(c, from)); }
+  int lastIndexOf(const String &s) const { return position(_s.rfind(s._s)); }
+
+  String substring(unsigned int from) const { return from < _s.size() ? _s.substr(from) : std::string(); }
+  String substring(unsigned int from, unsigned int to) const
+  {
+    if (from > to)
+      std::swap(from, to);
+    return from < _s.size() ? _s.substr(from, to - from) : std::string();
+  }
+
+  void replace(const String &find, const String &with)
+  {
+    if (find._s.empty())
+      return;
+    for (size_t pos = _s.find(find._s); pos != std::string::npos; pos = _s.find(find._s, pos + with._s.size()))
+      _s.replace(pos, find._s.size(), with._s);
+  }
+  void remove(unsigned int index) { _s.erase(std::min((size_t)index, _s.size())); }
+  void remove(unsigned int index, unsigned int count) { _s.erase(std::min((size_t)index, _s.size()), count); }
+  void trim()
+  {
+    size_t begin = _s.find_first_not_of(" \t\r\n");
+    size_t end = _s.find_last_not_of(" \t\r\n");
+    _s = begin == std::string::npos ? "" : _s.substr(begin, end - begin + 1);
+  }
+  void toLowerCase() { std::transform(_s.begin(), _s.end(), _s.begin(), ::tolower); }
+  void toUpperCase() { std::transform(_s.begin(), _s.end(), _s.begin(), ::toupper); }
+  long toInt() const { return atol(_s.c_str()); }
+
+  friend String operator+(const String &a, const String &b) { return a._s + b._s; }
+  friend String operator+(const String &a, const char *b) { return a._s + b; }
+  friend String operator+(const char *a, const String &b) { return a + b._s; }
+  friend String operator+(const String &a, char b) { return a._s + b; }
+
+private:
+  static int position(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+
+  std::string _s;
+};
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size)
+  {
+    size_t n = 0;
+    while (n < size && write(buffer[n]))
+      n++;
+    return n;
+  }
+  size_t write(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+  virtual void flush() {}
+
+  size_t print(const String &s) { return write(s.c_str()); }
+  size_t print(const char *s) { return write(s); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v) { return print(String(v)); }
+  size_t print(unsigned v) { return print(String(v)); }
+  size_t print(long v) { return print(String(v)); }
+  size_t print(unsigned long v) { return print(String(v)); }
+  template <typename T>
+  size_t println(const T &v) { return print(v) + print("\r\n"); }
+  size_t println() { return print("\r\n"); }
+
+  size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)))
+  {
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(nullptr, 0, format, args);
+    va_end(args);
+    if (len <= 0)
+      return 0;
+    std::string line(len + 1, '\0');
+    va_start(args, format);
+    vsnprintf(&line[0], line.size(), format, args);
+    va_end(args);
+    return write((const uint8_t *)line.data(), len);
+  }
+};
+
+class Stream : public Print
+{
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  void setTimeout(unsigned long timeout) { _timeout = timeout; }
+  unsigned long getTimeout() const { return _timeout; }
+
+  virtual size_t readBytes(char *buffer, size_t length)
+  {
+    size_t n = 0;
+    for (int c; n < length && (c = timedRead()) >= 0; n++)
+      buffer[n] = (char)c;
+    return n;
+  }
+  size_t readBytes(uint8_t *buffer, size_t length) { return readBytes((char *)buffer, length); }
+  size_t readBytesUntil(char terminator, char *buffer, size_t length)
+  {
+    size_t n = 0;
+    for (int c; n < length && (c = timedRead()) >= 0 && c != terminator; n++)
+      buffer[n] = (char)c;
+    return n;
+  }
+  String readString()
+  {
+    std::string s;
+    for (int c; (c = timedRead()) >= 0;)
+      s += (char)c;
+    return s;
+  }
+  String readStringUntil(char terminator)
+  {
+    std::string s;
+    for (int c; (c = timedRead()) >= 0 && c != terminator;)
+      s += (char)c;
+    return s;
+  }
+
+  bool find(const char *target) { return findUntil(target, nullptr); }
+  bool find(char target)
+  {
+    char s[2] = {target, '\0'};
+    return find(s);
+  }
+  bool findUntil(const char *target, const char *terminator)
+  {
+    size_t target_len = strlen(target), term_len = terminator ? strlen(terminator) : 0;
+    size_t matched = 0, term_matched = 0;
+    for (int c; (c = timedRead()) >= 0;)
+    {
+      matched = c == target[matched] ? matched + 1 : (c == target[0] ? 1 : 0);
+      if (matched == target_len)
+        return true;
+      if (term_len)
+      {
+        term_matched = c == terminator[term_matched] ? term_matched + 1 : (c == terminator[0] ? 1 : 0);
+        if (term_matched == term_len)
+          return false;
+      }
+    }
+    return false;
+  }
+
+protected:
+  int timedRead()
+  {
+    unsigned long start = millis();
+    do
+    {
+      int c = read();
+      if (c >= 0)
+        return c;
+      delay(1);
+    } while (millis() - start < _timeout);
+    return -1;
+  }
+
+  unsigned long _timeout = 1000;
+};
+
+class IPAddress
+{
+public:
+  IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : _bytes{a, b, c, d} {}
+  uint8_t operator[](int i) const { return _bytes[i]; }
+  String toString() const
+  {
+    char s[16];
+    snprintf(s, sizeof(s), "%u.%u.%u.%u", _bytes[0], _bytes[1], _bytes[2], _bytes[3]);
+    return s;
+  }
+
+private:
+  uint8_t _bytes[4];
+};
+
+class Client : public Stream
+{
+public:
+  virtual int connect(IPAddress ip, uint16_t port) = 0;
+  virtual int connect(const char *host, uint16_t port) = 0;
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size) = 0;
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int read(uint8_t *buffer, size_t size) = 0;
+  virtual int peek() = 0;
+  virtual void flush() = 0;
+  virtual void stop() = 0;
+  virtual uint8_t connected() = 0;
+  virtual operator bool() = 0;
+  using Print::write;
+};
+
+class HostSerial : public Stream
+{
+public:
+  void begin(unsigned long) {}
+  size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+  size_t write(const uint8_t *buffer, size_t size) override { return fwrite(buffer, 1, size, stdout); }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  using Print::write;
+};
+
+inline HostSerial Serial;
+
+#endif
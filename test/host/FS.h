@@ -0,0 +1,105 @@
+#ifndef GITHUBOTA_HOST_FS_H
+#define GITHUBOTA_HOST_FS_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+
+// In-memory filesystem with the fs::FS / fs::File interface of the cores
+namespace fs
+{
+typedef std::vector<uint8_t> HostFileData;
+
+class File : public Stream
+{
+public:
+  File() {}
+  File(std::shared_ptr<HostFileData> data, bool append) : _data(data), _position(append ? data->size() : 0) {}
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *buffer, size_t size) override
+  {
+    if (!_data)
+      return 0;
+    if (_data->size() < _position + size)
+      _data->resize(_position + size);
+    memcpy(_data->data() + _position, buffer, size);
+    _position += size;
+    return size;
+  }
+  int available() override { return _data ? _data->size() - _position : 0; }
+  int read() override { return available() ? (*_data)[_position++] : -1; }
+  int read(uint8_t *buffer, size_t size)
+  {
+    size = std::min(size, (size_t)available());
+    if (size)
+      memcpy(buffer, _data->data() + _position, size);
+    _position += size;
+    return size;
+  }
+  size_t readBytes(char *buffer, size_t length) override { return read((uint8_t *)buffer, length); }
+  int peek() override { return available() ? (*_data)[_position] : -1; }
+  bool seek(uint32_t position)
+  {
+    if (!_data || position > _data->size())
+      return false;
+    _position = position;
+    return true;
+  }
+  size_t position() const { return _position; }
+  size_t size() const { return _data ? _data->size() : 0; }
+  void close() { _data.reset(); }
+  operator bool() const { return (bool)_data; }
+  using Print::write;
+
+private:
+  std::shared_ptr<HostFileData> _data;
+  size_t _position = 0;
+};
+
+class FS
+{
+public:
+  File open(const String &path, const char *mode = "r")
+  {
+    auto it = _files.find(path.c_str());
+    if (mode[0] == 'r')
+      return it == _files.end() ? File() : File(it->second, false);
+
+    // "w" truncates, "a" appends; File keeps writing into the shared data
+    if (it == _files.end() || mode[0] == 'w')
+      it = _files.insert_or_assign(path.c_str(), std::make_shared<HostFileData>()).first;
+    return File(it->second, mode[0] == 'a');
+  }
+  bool exists(const String &path) const { return _files.count(path.c_str()) > 0; }
+  bool remove(const String &path) { return _files.erase(path.c_str()) > 0; }
+  bool rename(const String &from, const String &to)
+  {
+    auto it = _files.find(from.c_str());
+    if (it == _files.end())
+      return false;
+    _files[to.c_str()] = it->second;
+    _files.erase(from.c_str());
+    return true;
+  }
+  bool mkdir(const String &) { return true; }
+
+  // Test access to the file contents
+  HostFileData *data(const String &path)
+  {
+    auto it = _files.find(path.c_str());
+    return it == _files.end() ? nullptr : it->second.get();
+  }
+
+private:
+  std::map<std::string, std::shared_ptr<HostFileData>> _files;
+};
+} // namespace fs
+
+using fs::File;
+using fs::FS;
+
+#endif
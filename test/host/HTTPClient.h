@@ -0,0 +1,12 @@
+#ifndef GITHUBOTA_HOST_HTTPCLIENT_H
+#define GITHUBOTA_HOST_HTTPCLIENT_H
+
+// Status codes of the cores' HTTPClient. The library includes HTTPClient.h
+// only on the devices, host tests include this before its sources.
+#define HTTP_CODE_OK 200
+#define HTTP_CODE_PARTIAL_CONTENT 206
+#define HTTP_CODE_MOVED_PERMANENTLY 301
+#define HTTP_CODE_FOUND 302
+#define HTTP_CODE_NOT_MODIFIED 304
+
+#endif
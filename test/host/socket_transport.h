@@ -0,0 +1,225 @@
+#ifndef GITHUBOTA_HOST_SOCKET_TRANSPORT_H
+#define GITHUBOTA_HOST_SOCKET_TRANSPORT_H
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "Arduino.h"
+#include "transport.h"
+
+// Arduino Client over a POSIX TCP socket, so host tests and benchmarks talk to
+// real (local) servers through the library's transport and HTTP code
+class SocketClient : public Client
+{
+public:
+  SocketClient() : _fd(-1), _peek(-1), _connects(0) {}
+  ~SocketClient() { stop(); }
+
+  int connect(IPAddress ip, uint16_t port) override { return connect(ip.toString().c_str(), port); }
+  int connect(const char *host, uint16_t port) override
+  {
+    stop();
+    addrinfo hints = {}, *addresses = nullptr;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host, String((unsigned)port).c_str(), &hints, &addresses) != 0)
+      return 0;
+    for (addrinfo *address = addresses; address && _fd < 0; address = address->ai_next)
+    {
+      _fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+      if (_fd >= 0 && ::connect(_fd, address->ai_addr, address->ai_addrlen) != 0)
+      {
+        close(_fd);
+        _fd = -1;
+      }
+    }
+    freeaddrinfo(addresses);
+    if (_fd < 0)
+      return 0;
+    int one = 1;
+    setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    _connects++;
+    return 1;
+  }
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *buffer, size_t size) override
+  {
+    size_t sent = 0;
+    while (_fd >= 0 && sent < size)
+    {
+      ssize_t n = send(_fd, buffer + sent, size - sent, MSG_NOSIGNAL);
+      if (n <= 0)
+        break;
+      sent += n;
+    }
+    return sent;
+  }
+
+  int available() override
+  {
+    if (_peek >= 0)
+      return 1;
+    if (_fd < 0)
+      return 0;
+    uint8_t c;
+    ssize_t n = recv(_fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0)
+      _closed = true;
+    return n > 0 ? 1 : 0;
+  }
+  int read() override
+  {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+  }
+  int read(uint8_t *buffer, size_t size) override
+  {
+    if (!size)
+      return 0;
+    size_t n = 0;
+    if (_peek >= 0)
+    {
+      buffer[n++] = (uint8_t)_peek;
+      _peek = -1;
+    }
+    if (_fd >= 0 && n < size)
+    {
+      ssize_t received = recv(_fd, buffer + n, size - n, MSG_DONTWAIT);
+      if (received == 0)
+        _closed = true;
+      if (received > 0)
+        n += received;
+    }
+    return n ? (int)n : -1;
+  }
+  size_t readBytes(char *buffer, size_t length) override
+  {
+    // Blocks up to the stream timeout in real time, the server is real
+    size_t n = 0;
+    while (n < length && wait_readable())
+    {
+      int received = read((uint8_t *)buffer + n, length - n);
+      if (received <= 0)
+        break;
+      n += received;
+    }
+    return n;
+  }
+  int peek() override
+  {
+    if (_peek < 0)
+      _peek = read();
+    return _peek;
+  }
+  void flush() override {}
+  void stop() override
+  {
+    if (_fd >= 0)
+      close(_fd);
+    _fd = -1;
+    _peek = -1;
+    _closed = false;
+  }
+  uint8_t connected() override
+  {
+    if (_fd < 0)
+      return 0;
+    available();
+    return !_closed || _peek >= 0;
+  }
+  operator bool() override { return _fd >= 0; }
+  using Print::write;
+
+  uint32_t connects() const { return _connects; }
+
+private:
+  bool wait_readable()
+  {
+    if (_peek >= 0)
+      return true;
+    if (_fd < 0)
+      return false;
+    pollfd entry = {_fd, POLLIN, 0};
+    return poll(&entry, 1, _timeout) > 0;
+  }
+
+  int _fd;
+  int _peek;
+  bool _closed = false;
+  uint32_t _connects;
+};
+
+// Transport over SocketClient slots. Plain TCP only, TLS is not simulated;
+// tests serve http:// URLs from a local server.
+class SocketTransport : public OtaTransport
+{
+public:
+  SocketClient &client(size_t slot) { return _clients[slot]; }
+
+protected:
+  size_t slots() override { return GITHUBOTA_POOL_SIZE; }
+  Client *open(size_t slot, const String &host, uint16_t port, bool secure) override
+  {
+    if (secure)
+      return nullptr;
+    return _clients[slot].connect(host.c_str(), port) ? &_clients[slot] : nullptr;
+  }
+
+private:
+  SocketClient _clients[GITHUBOTA_POOL_SIZE];
+};
+
+// Every connection goes to one local server whatever the host, and https is
+// served in plain text: stands in for GitHub, its API and the asset CDN
+class LoopbackTransport : public OtaTransport
+{
+public:
+  LoopbackTransport(uint16_t port = 0) : _port(port) {}
+  void set_port(uint16_t port) { _port = port; }
+
+protected:
+  size_t slots() override { return GITHUBOTA_POOL_SIZE; }
+  Client *open(size_t slot, const String &host, uint16_t port, bool secure) override
+  {
+    return _clients[slot].connect("127.0.0.1", _port) ? &_clients[slot] : nullptr;
+  }
+
+private:
+  uint16_t _port;
+  SocketClient _clients[GITHUBOTA_POOL_SIZE];
+};
+
+// Default transport of the updaters on the host, tests replace it with
+// set_transport()
+class WiFiSecureTransport : public SocketTransport
+{
+};
+
+// Listening socket on 127.0.0.1 with an ephemeral port for test servers
+inline int host_listen(uint16_t &port)
+{
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t length = sizeof(address);
+  if (bind(fd, (sockaddr *)&address, length) != 0 || listen(fd, 8) != 0 ||
+      getsockname(fd, (sockaddr *)&address, &length) != 0)
+  {
+    close(fd);
+    return -1;
+  }
+  port = ntohs(address.sin_port);
+  return fd;
+}
+
+#endif
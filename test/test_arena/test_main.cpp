@@ -0,0 +1,175 @@
+#include <thread>
+
+#include <unity.h>
+
+#include "arena.cpp"
+#include "catalog.h"
+#include "http.h"
+#include "partition_writer.h"
+
+// Heap allocations are counted by interposing malloc() (glibc)
+static bool counting = false;
+static uint32_t heap_allocations = 0;
+
+#ifdef __GLIBC__
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+
+extern "C" void *malloc(size_t size) __THROW
+{
+  if (counting)
+    heap_allocations++;
+  return __libc_malloc(size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size) __THROW
+{
+  if (counting)
+    heap_allocations++;
+  return __libc_realloc(ptr, size);
+}
+#endif
+
+// The allocations of a check with the catalog: a header line for every
+// response, the merge buffer and one asset document after the other, then
+// the download's header line and sector buffer
+static void catalog_check()
+{
+  void *line = ota_malloc(HTTP_MAX_LINE);
+  ota_free(line);
+  void *fresh = ota_malloc(CATALOG_MERGE_SIZE);
+  for (int i = 0; i < GITHUBOTA_CATALOG_SIZE; i++)
+  {
+    void *doc = ota_malloc(RELEASE_ASSET_JSON_SIZE);
+    // The document pool shrinks in place after parsing
+    doc = ota_realloc(doc, RELEASE_ASSET_JSON_SIZE / 2);
+    ota_free(doc);
+  }
+  ota_free(fresh);
+
+  line = ota_malloc(HTTP_MAX_LINE);
+  ota_free(line);
+  void *sector = ota_malloc(PARTITION_SECTOR_SIZE);
+  line = ota_malloc(HTTP_MAX_LINE);
+  ota_free(line);
+  ota_free(sector);
+}
+
+// arena_size_for() lives in common.cpp, which needs the device cores
+static size_t catalog_arena_size()
+{
+  size_t line = OtaArena::footprint(HTTP_MAX_LINE);
+  size_t lookup = OtaArena::footprint(CATALOG_MERGE_SIZE) + OtaArena::footprint(RELEASE_ASSET_JSON_SIZE);
+  size_t download = OtaArena::footprint(PARTITION_SECTOR_SIZE);
+  return line + std::max(lookup, download) + 4 * OtaArena::footprint(32);
+}
+
+void setUp()
+{
+  heap_allocations = 0;
+}
+
+void tearDown()
+{
+  counting = false;
+}
+
+void test_check_without_arena_uses_the_heap()
+{
+#ifndef __GLIBC__
+  TEST_IGNORE_MESSAGE("Counting needs glibc");
+#endif
+  counting = true;
+  catalog_check();
+  counting = false;
+  TEST_ASSERT_EQUAL_UINT32(3 + 2 * GITHUBOTA_CATALOG_SIZE + 2, heap_allocations);
+}
+
+void test_check_in_reserved_arena_does_not_allocate()
+{
+#ifndef __GLIBC__
+  TEST_IGNORE_MESSAGE("Counting needs glibc");
+#endif
+  OtaArena arena(catalog_arena_size(), true);
+  counting = true;
+  for (int check = 0; check < 3; check++)
+  {
+    TEST_ASSERT_TRUE(arena.begin());
+    catalog_check();
+    TEST_ASSERT_EQUAL_UINT32(0, arena.overflows());
+    arena.end();
+  }
+  counting = false;
+  TEST_ASSERT_EQUAL_UINT32(0, heap_allocations);
+  TEST_ASSERT_LESS_OR_EQUAL(arena.size(), arena.peak());
+}
+
+void test_borrowed_arena_allocates_once_per_check()
+{
+#ifndef __GLIBC__
+  TEST_IGNORE_MESSAGE("Counting needs glibc");
+#endif
+  OtaArena arena(catalog_arena_size(), false);
+  counting = true;
+  TEST_ASSERT_TRUE(arena.begin());
+  catalog_check();
+  arena.end();
+  counting = false;
+  TEST_ASSERT_EQUAL_UINT32(1, heap_allocations);
+}
+
+// The previous default of 6144 bytes did not hold the catalog path while a
+// whole release was parsed at once; one asset at a time it does
+void test_catalog_fits_the_old_default()
+{
+  OtaArena arena(6144, true);
+  TEST_ASSERT_TRUE(arena.begin());
+  catalog_check();
+  TEST_ASSERT_EQUAL_UINT32(0, arena.overflows());
+  arena.end();
+}
+
+void test_arena_is_active_in_its_thread_only()
+{
+  OtaArena arena(1024, true);
+  TEST_ASSERT_TRUE(arena.begin());
+  TEST_ASSERT_TRUE(OtaArena::active() == &arena);
+
+  OtaArena *seen = &arena;
+  void *block = nullptr;
+  std::thread other([&]() {
+    seen = OtaArena::active();
+    block = ota_malloc(64);
+  });
+  other.join();
+  TEST_ASSERT_NULL(seen);
+  TEST_ASSERT_FALSE(arena.owns(block));
+  free(block);
+  arena.end();
+  TEST_ASSERT_NULL(OtaArena::active());
+}
+
+void test_arena_serves_one_check_at_a_time()
+{
+  OtaArena arena(1024, true);
+  TEST_ASSERT_TRUE(arena.begin());
+  TEST_ASSERT_FALSE(arena.begin());
+  TEST_ASSERT_FALSE(arena.resize(2048));
+  arena.end();
+  TEST_ASSERT_TRUE(arena.resize(2048));
+  TEST_ASSERT_EQUAL_size_t(2048, arena.size());
+  TEST_ASSERT_TRUE(arena.begin());
+  arena.end();
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_check_without_arena_uses_the_heap);
+  RUN_TEST(test_check_in_reserved_arena_does_not_allocate);
+  RUN_TEST(test_borrowed_arena_allocates_once_per_check);
+  RUN_TEST(test_catalog_fits_the_old_default);
+  RUN_TEST(test_arena_is_active_in_its_thread_only);
+  RUN_TEST(test_arena_serves_one_check_at_a_time);
+  return UNITY_END();
+}
@@ -0,0 +1,320 @@
+// On-device download benchmarks against tools/bench_server.py on the LAN.
+// WiFi and the server are given as build flags, see the server's usage:
+// BENCH_SSID, BENCH_PASS and BENCH_URL (http://<host>:<port>/image.bin).
+// The data path measurement needs no network. Images go into the filesystem
+// partition, which is overwritten, and is then formatted for the file sync
+// comparison.
+
+#include <Arduino.h>
+#ifdef ESP8266
+#include <ESP8266WiFi.h>
+#include <ESP8266HTTPClient.h>
+#elif defined(ESP32)
+#include <WiFi.h>
+#include <HTTPClient.h>
+#endif
+#include <LittleFS.h>
+#include <unity.h>
+
+#include "transport.h"
+#include "common.h"
+#include "http.h"
+#include "sha256.h"
+#include "parallel.h"
+#include "partition_writer.h"
+#include "file_sync.h"
+
+#define DATA_PATH_IMAGE_SIZE (1024 * 1024)
+
+static size_t image_size = 0;
+// Lowest free heap seen by the progress callbacks; the sector buffer and the
+// connection are held for the whole transfer, so this catches the peak
+static uint32_t lowest_free_heap = 0;
+
+static void on_progress(void *ctx, size_t current, size_t total, const update_stats_t &stats)
+{
+  image_size = total;
+  lowest_free_heap = std::min(lowest_free_heap, ESP.getFreeHeap());
+}
+
+// Reports time per MB and peak heap use of one transfer
+static void report(const char *what, uint32_t elapsed, uint32_t free_before)
+{
+  char message[128];
+  snprintf(message, sizeof(message), "%s: %u ms/MB, peak heap %u bytes",
+           what, (unsigned)((uint64_t)elapsed * 1024 * 1024 / image_size), free_before - lowest_free_heap);
+  TEST_MESSAGE(message);
+}
+
+// Pseudo-random image generated on the fly and handed out in TCP segment
+// sized pieces, like a socket
+class PatternStream : public Stream
+{
+public:
+  PatternStream(size_t size) : _size(size), _position(0), _state(0x2545F491) {}
+
+  size_t write(uint8_t) override { return 0; }
+  int available() override { return std::min((size_t)1460, _size - _position); }
+  int read() override
+  {
+    char c;
+    return readBytes(&c, 1) == 1 ? (uint8_t)c : -1;
+  }
+  int peek() override { return -1; }
+  size_t readBytes(char *buffer, size_t length) override
+  {
+    length = std::min(length, _size - _position);
+    for (size_t i = 0; i < length; i++)
+    {
+      _state ^= _state << 13;
+      _state ^= _state >> 17;
+      _state ^= _state << 5;
+      buffer[i] = (char)_state;
+    }
+    _position += length;
+    return length;
+  }
+  using Print::write;
+
+private:
+  size_t _size;
+  size_t _position;
+  uint32_t _state;
+};
+
+// WiFiClient counting the bytes it receives, response headers included
+class CountingClient : public WiFiClient
+{
+public:
+  CountingClient() : received(0) {}
+
+  int read() override
+  {
+    int c = WiFiClient::read();
+    if (c >= 0)
+      received++;
+    return c;
+  }
+  int read(uint8_t *buffer, size_t size) override
+  {
+    int len = WiFiClient::read(buffer, size);
+    if (len > 0)
+      received += len;
+    return len;
+  }
+
+  uint32_t received;
+};
+
+#if defined(BENCH_SSID) && defined(BENCH_URL)
+static WiFiSecureTransport transport;
+static uint8_t digest[SHA256_DIGEST_SIZE];
+static bool ready = false;
+
+static bool fetch_digest(const String &url, uint8_t *sha256)
+{
+  OtaHttp http(transport);
+  bool ok = http.get(url + ".sha256") == HTTP_CODE_OK;
+  char hex[2 * SHA256_DIGEST_SIZE + 1] = {0};
+  ok = ok && http.stream().readBytes(hex, sizeof(hex) - 1) == sizeof(hex) - 1;
+  http.end();
+  return ok && parse_hex_digest(hex, sha256);
+}
+
+// URL of another file of the bench server
+static String bench_url(const char *name)
+{
+  String url = BENCH_URL;
+  return url.substring(0, url.lastIndexOf('/') + 1) + name;
+}
+
+// Every run opens its connections, as a check after a poll interval would
+static uint32_t timed_download(uint8_t streams)
+{
+  transport.close_idle();
+  update_control_t control = {false, false, 0, false, false, streams, nullptr, on_progress, nullptr};
+  unsigned long started = millis();
+  bool ok = download_update(transport, BENCH_URL, digest, U_FILESYSTEM, &control);
+  uint32_t elapsed = millis() - started;
+  TEST_ASSERT_TRUE_MESSAGE(ok, "Download failed");
+  return elapsed;
+}
+#endif
+
+// Ignores the calling test without the bench server
+static void require_server()
+{
+#if defined(BENCH_SSID) && defined(BENCH_URL)
+  if (!ready)
+    TEST_IGNORE_MESSAGE("No connection to the bench server");
+#else
+  TEST_IGNORE_MESSAGE("Set BENCH_SSID, BENCH_PASS and BENCH_URL");
+#endif
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+// CPU time of the data path without the network: segments are read straight
+// into the sector buffer, hashed, compared with flash and programmed. The
+// second run finds every sector unchanged, which leaves reading, hashing and
+// comparing.
+void test_data_path_cost()
+{
+  size_t size = std::min((size_t)DATA_PATH_IMAGE_SIZE, PartitionWriter::capacity(U_FILESYSTEM));
+  size -= size % PARTITION_SECTOR_SIZE;
+
+  PatternStream pattern(size);
+  Sha256 hash;
+  uint8_t expected[SHA256_DIGEST_SIZE];
+  uint8_t chunk[256];
+  for (size_t done = 0; done < size; done += sizeof(chunk))
+  {
+    pattern.readBytes((char *)chunk, sizeof(chunk));
+    hash.update(chunk, sizeof(chunk));
+  }
+  hash.finish(expected);
+
+  const char *runs[] = {"Data path, sectors programmed", "Data path, sectors unchanged"};
+  for (const char *run : runs)
+  {
+    PatternStream stream(size);
+    update_control_t control = {false, false, 0, false, false, 1, nullptr, on_progress, nullptr};
+    uint32_t free_before = ESP.getFreeHeap();
+    lowest_free_heap = free_before;
+    unsigned long started = millis();
+    bool ok = update_from_stream(stream, size, expected, U_FILESYSTEM, &control);
+    uint32_t elapsed = millis() - started;
+    TEST_ASSERT_TRUE_MESSAGE(ok, "Update failed");
+    report(run, elapsed, free_before);
+  }
+}
+
+// The same over one connection to the bench server
+void test_download_cost()
+{
+  require_server();
+#if defined(BENCH_SSID) && defined(BENCH_URL)
+  uint32_t free_before = ESP.getFreeHeap();
+  lowest_free_heap = free_before;
+  uint32_t elapsed = timed_download(1);
+  report("Download", elapsed, free_before);
+#endif
+}
+
+#if defined(BENCH_SSID) && defined(BENCH_URL)
+static void report_transfer(const char *what, uint32_t bytes, uint32_t elapsed)
+{
+  char message[96];
+  snprintf(message, sizeof(message), "%s: %u bytes in %u ms", what, bytes, elapsed);
+  TEST_MESSAGE(message);
+}
+
+// Syncs the bench server's files into the formatted filesystem
+static void timed_sync(const char *what, ClientTransport &counted, CountingClient &client, const uint8_t *manifest_sha256)
+{
+  counted.close_idle();
+  client.received = 0;
+  unsigned long started = millis();
+  bool ok = sync_files(counted, LittleFS, bench_url("filesystem.manifest"), bench_url("filesystem.pack"), manifest_sha256);
+  uint32_t elapsed = millis() - started;
+  TEST_ASSERT_TRUE_MESSAGE(ok, "Sync failed");
+  report_transfer(what, client.received, elapsed);
+}
+#endif
+
+// The same release as one filesystem image and as file sync: the server's
+// pack holds the image's data split into files. Sync runs into an empty
+// filesystem, after 1 in 8 files changed and with nothing changed.
+void test_sync_versus_image()
+{
+  require_server();
+#if defined(BENCH_SSID) && defined(BENCH_URL)
+  uint8_t manifest_sha256[SHA256_DIGEST_SIZE];
+  TEST_ASSERT_TRUE_MESSAGE(fetch_digest(bench_url("filesystem.manifest"), manifest_sha256), "No manifest digest");
+
+  CountingClient client;
+  ClientTransport counted(client, false);
+  update_control_t control = {false, false, 0, false, false, 1, nullptr, on_progress, nullptr};
+  unsigned long started = millis();
+  bool ok = download_update(counted, BENCH_URL, digest, U_FILESYSTEM, &control);
+  uint32_t elapsed = millis() - started;
+  TEST_ASSERT_TRUE_MESSAGE(ok, "Download failed");
+  report_transfer("Filesystem image", client.received, elapsed);
+
+  // The image is random data, not a filesystem
+  TEST_ASSERT_TRUE_MESSAGE(LittleFS.format() && LittleFS.begin(), "Unable to format the filesystem");
+  timed_sync("File sync, all files", counted, client, manifest_sha256);
+
+  char path[32];
+  for (unsigned i = 0;; i += 8)
+  {
+    snprintf(path, sizeof(path), "/bench/%03u.bin", i);
+    if (!LittleFS.exists(path))
+      break;
+    File file = LittleFS.open(path, "r+");
+    uint8_t first = file.read();
+    file.seek(0);
+    file.write((uint8_t)~first);
+    file.close();
+  }
+  timed_sync("File sync, 1 in 8 files", counted, client, manifest_sha256);
+  timed_sync("File sync, no changes", counted, client, manifest_sha256);
+  LittleFS.end();
+#endif
+}
+
+#ifdef ESP32
+// Throughput over 1 to GITHUBOTA_POOL_SIZE Range streams; start the server
+// with --latency and --rate to model a WAN path
+void test_parallel_throughput()
+{
+  require_server();
+#if defined(BENCH_SSID) && defined(BENCH_URL)
+  uint32_t single = 0;
+  for (uint8_t streams = 1; streams <= std::min(GITHUBOTA_POOL_SIZE, PARALLEL_MAX_STREAMS); streams++)
+  {
+    uint32_t elapsed = timed_download(streams);
+    if (streams == 1)
+      single = elapsed;
+
+    char message[96];
+    snprintf(message, sizeof(message), "%u streams: %u ms, %u KB/s, speedup %u%%",
+             streams, elapsed, (unsigned)(image_size / elapsed), single * 100 / elapsed);
+    TEST_MESSAGE(message);
+  }
+#endif
+}
+#endif
+
+void setup()
+{
+  Serial.begin(115200);
+  delay(2000);
+
+#if defined(BENCH_SSID) && defined(BENCH_URL)
+  WiFi.mode(WIFI_STA);
+  WiFi.begin(BENCH_SSID, BENCH_PASS);
+  for (int i = 0; i < 60 && WiFi.status() != WL_CONNECTED; i++)
+    delay(500);
+  ready = WiFi.status() == WL_CONNECTED && fetch_digest(BENCH_URL, digest);
+#endif
+
+  UNITY_BEGIN();
+  RUN_TEST(test_data_path_cost);
+  RUN_TEST(test_download_cost);
+#ifdef ESP32
+  RUN_TEST(test_parallel_throughput);
+#endif
+  RUN_TEST(test_sync_versus_image);
+  UNITY_END();
+}
+
+void loop()
+{
+}
@@ -0,0 +1,228 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unity.h>
+
+#include "HTTPClient.h"
+#include "socket_transport.h"
+#include "arena.cpp"
+#include "common.cpp"
+#include "events.cpp"
+#include "file_sync.cpp"
+#include "http.cpp"
+#include "release_url.cpp"
+#include "semver_extensions.cpp"
+#include "sha256.cpp"
+#include "sink.cpp"
+#include "throttle.cpp"
+#include "transport.cpp"
+#include "GitHubFsOTA.cpp"
+
+// The filesystem partition, in memory. Pre-flight checks need the chip and
+// pass on the host.
+static std::vector<uint8_t> written_image;
+
+PartitionWriter::PartitionWriter(int command, const char *label)
+{
+  _command = command;
+  _label = label;
+  _sector = nullptr;
+}
+
+PartitionWriter::~PartitionWriter()
+{
+  release();
+}
+
+size_t PartitionWriter::capacity(int command, const char *label)
+{
+  return 1024 * 1024;
+}
+
+bool PartitionWriter::begin(size_t size)
+{
+  _size = size;
+  _offset = 0;
+  _buffered = 0;
+  written_image.clear();
+  _sector = (uint32_t *)ota_malloc(buffer_size());
+  return _sector != nullptr;
+}
+
+size_t PartitionWriter::write(const uint8_t *data, size_t len)
+{
+  return 0;
+}
+
+uint8_t *PartitionWriter::reserve(size_t &len)
+{
+  len = std::min(len, buffer_size() - _buffered);
+  return (uint8_t *)_sector + _buffered;
+}
+
+bool PartitionWriter::commit(size_t len)
+{
+  _buffered += len;
+  return _buffered < buffer_size() || flush_sector();
+}
+
+bool PartitionWriter::flush_sector()
+{
+  written_image.insert(written_image.end(), (uint8_t *)_sector, (uint8_t *)_sector + _buffered);
+  _offset += _buffered;
+  _buffered = 0;
+  return true;
+}
+
+bool PartitionWriter::finalize()
+{
+  bool ok = flush_sector() && _offset == _size;
+  release();
+  return ok;
+}
+
+void PartitionWriter::abort()
+{
+  release();
+}
+
+size_t PartitionWriter::buffer_size() const
+{
+  return PARTITION_SECTOR_SIZE;
+}
+
+void PartitionWriter::release()
+{
+  ota_free(_sector);
+  _sector = nullptr;
+}
+
+bool preflight_check(const release_asset_t &asset, int command, String &reason, const char *partition)
+{
+  return true;
+}
+
+// GitHub: the latest release redirects to its tag, the asset is served from
+// the download URL. The latest tag can be changed between checks.
+static int listener = -1;
+static uint16_t port = 0;
+static std::string latest_tag;
+static std::string image;
+static std::atomic<int> downloads(0);
+
+static void respond(int fd, const std::string &path)
+{
+  std::string response;
+  if (path == "/owner/repo/releases/latest")
+  {
+    response = "HTTP/1.1 302 Found\r\nLocation: https://github.com/owner/repo/releases/tag/" + latest_tag +
+               "\r\nContent-Length: 0\r\n\r\n";
+  }
+  else if (path == "/owner/repo/releases/download/" + latest_tag + "/filesystem.bin")
+  {
+    downloads++;
+    response = "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(image.size()) + "\r\n\r\n" + image;
+  }
+  else
+  {
+    response = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+  }
+  send(fd, response.data(), response.size(), MSG_NOSIGNAL);
+}
+
+static void serve(int fd)
+{
+  std::string request;
+  char buffer[1024];
+  for (ssize_t n; (n = recv(fd, buffer, sizeof(buffer), 0)) > 0;)
+  {
+    request.append(buffer, n);
+    for (size_t end; (end = request.find("\r\n\r\n")) != std::string::npos;)
+    {
+      size_t path = request.find(' ') + 1;
+      respond(fd, request.substr(path, request.find(' ', path) - path));
+      request.erase(0, end + 4);
+    }
+  }
+  close(fd);
+}
+
+static void accept_loop()
+{
+  for (int fd; (fd = accept(listener, nullptr, nullptr)) >= 0;)
+    std::thread(serve, fd).detach();
+}
+
+static std::vector<ota_event_type_t> events;
+
+static void on_event(void *ctx, const ota_event_t &event)
+{
+  if (event.type != OTA_EVENT_PROGRESS)
+    events.push_back(event.type);
+}
+
+static ota_event_type_t check(GitHubFsOTA &ota)
+{
+  events.clear();
+  ota.handle();
+  return events.empty() ? OTA_EVENT_CHECKING : events.back();
+}
+
+void setUp()
+{
+  host_real_time = true;
+  image.resize(3 * PARTITION_SECTOR_SIZE + 100);
+  for (size_t i = 0; i < image.size(); i++)
+    image[i] = (char)(i * 7);
+}
+
+void tearDown()
+{
+}
+
+// The installed version is kept after the arena of its check is released
+static void updates_twice_to_prereleases(bool reserve)
+{
+  LoopbackTransport transport(port);
+  GitHubFsOTA ota("1.0.0", "https://github.com/owner/repo/releases/latest", "filesystem.bin", true);
+  ota.set_transport(transport);
+  ota.on_event(on_event);
+  ota.enable_arena(16384, reserve);
+  downloads = 0;
+
+  latest_tag = "v1.2.3-rc.1";
+  TEST_ASSERT_EQUAL_INT(OTA_EVENT_FINISHED, check(ota));
+  TEST_ASSERT_EQUAL_INT(1, downloads.load());
+  TEST_ASSERT_TRUE(std::string(written_image.begin(), written_image.end()) == image);
+  TEST_ASSERT_EQUAL_INT(OTA_EVENT_NO_UPDATE, check(ota));
+
+  latest_tag = "v1.2.3-rc.2";
+  TEST_ASSERT_EQUAL_INT(OTA_EVENT_FINISHED, check(ota));
+  TEST_ASSERT_EQUAL_INT(2, downloads.load());
+  TEST_ASSERT_EQUAL_INT(OTA_EVENT_NO_UPDATE, check(ota));
+  TEST_ASSERT_EQUAL_INT(OTA_EVENT_NO_UPDATE, check(ota));
+  TEST_ASSERT_EQUAL_INT(2, downloads.load());
+}
+
+void test_prerelease_updates_with_reserved_arena()
+{
+  updates_twice_to_prereleases(true);
+}
+
+void test_prerelease_updates_with_borrowed_arena()
+{
+  updates_twice_to_prereleases(false);
+}
+
+int main()
+{
+  listener = host_listen(port);
+  std::thread(accept_loop).detach();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_prerelease_updates_with_reserved_arena);
+  RUN_TEST(test_prerelease_updates_with_borrowed_arena);
+  return UNITY_END();
+}
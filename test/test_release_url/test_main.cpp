@@ -0,0 +1,181 @@
+#include <chrono>
+
+#include <unity.h>
+
+#include "release_url.cpp"
+
+// Heap allocations are counted by interposing malloc() (glibc)
+static uint32_t heap_allocations = 0;
+
+#ifdef __GLIBC__
+extern "C" void *__libc_malloc(size_t size);
+
+extern "C" void *malloc(size_t size) __THROW
+{
+  heap_allocations++;
+  return __libc_malloc(size);
+}
+#endif
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_parse_release_page_and_download_urls()
+{
+  release_ref_t ref;
+  TEST_ASSERT_TRUE(parse_release_url("https://github.com/axcap/Esp-GitHub-OTA/releases/tag/v0.1.4", ref));
+  TEST_ASSERT_EQUAL_STRING("axcap", ref.owner);
+  TEST_ASSERT_EQUAL_STRING("Esp-GitHub-OTA", ref.repo);
+  TEST_ASSERT_EQUAL_STRING("v0.1.4", ref.tag);
+
+  TEST_ASSERT_TRUE(parse_release_url("https://github.com/axcap/Esp-GitHub-OTA/releases/download/0.1.4/", ref));
+  TEST_ASSERT_EQUAL_STRING("0.1.4", ref.tag);
+}
+
+// replace("tag", "download") rewrote every "tag" in the URL
+void test_parse_names_containing_tag()
+{
+  release_ref_t ref;
+  TEST_ASSERT_TRUE(parse_release_url("https://github.com/tagger/vintage-tag/releases/tag/stage-1.2.0", ref));
+  TEST_ASSERT_EQUAL_STRING("tagger", ref.owner);
+  TEST_ASSERT_EQUAL_STRING("vintage-tag", ref.repo);
+  TEST_ASSERT_EQUAL_STRING("stage-1.2.0", ref.tag);
+
+  char url[RELEASE_URL_SIZE];
+  TEST_ASSERT_TRUE(build_download_url(ref, "firmware.bin", url, sizeof(url)));
+  TEST_ASSERT_EQUAL_STRING("https://github.com/tagger/vintage-tag/releases/download/stage-1.2.0/firmware.bin", url);
+  TEST_ASSERT_TRUE(build_download_url(ref, "", url, sizeof(url)));
+  TEST_ASSERT_EQUAL_STRING("https://github.com/tagger/vintage-tag/releases/download/stage-1.2.0/", url);
+}
+
+void test_parse_tags_with_slashes()
+{
+  release_ref_t ref;
+  TEST_ASSERT_TRUE(parse_release_url("https://github.com/o/r/releases/tag/app/v2.0.0", ref));
+  TEST_ASSERT_EQUAL_STRING("app/v2.0.0", ref.tag);
+}
+
+void test_reject_malformed_urls()
+{
+  release_ref_t ref;
+  TEST_ASSERT_FALSE(parse_release_url(nullptr, ref));
+  TEST_ASSERT_FALSE(parse_release_url("", ref));
+  TEST_ASSERT_FALSE(parse_release_url("https://github.com/o/r", ref));
+  TEST_ASSERT_FALSE(parse_release_url("https://github.com/o/r/releases/latest", ref));
+  TEST_ASSERT_FALSE(parse_release_url("https://github.com/o/r/releases/tag/", ref));
+  TEST_ASSERT_FALSE(parse_release_url("https://github.com//r/releases/tag/v1", ref));
+
+  // Owner names are limited to 39 characters
+  char url[RELEASE_URL_SIZE];
+  snprintf(url, sizeof(url), "https://github.com/%s/r/releases/tag/v1", std::string(40, 'o').c_str());
+  TEST_ASSERT_FALSE(parse_release_url(url, ref));
+}
+
+void test_build_download_url_too_small()
+{
+  release_ref_t ref;
+  TEST_ASSERT_TRUE(parse_release_url("https://github.com/o/r/releases/tag/v1.0.0", ref));
+  char url[40];
+  TEST_ASSERT_FALSE(build_download_url(ref, "firmware.bin", url, sizeof(url)));
+}
+
+void test_parse_repo_urls()
+{
+  release_ref_t ref;
+  TEST_ASSERT_TRUE(parse_repo_url("https://api.github.com/repos/axcap/Esp-GitHub-OTA/releases/latest", ref));
+  TEST_ASSERT_EQUAL_STRING("axcap", ref.owner);
+  TEST_ASSERT_EQUAL_STRING("Esp-GitHub-OTA", ref.repo);
+  TEST_ASSERT_EQUAL_STRING("", ref.tag);
+
+  TEST_ASSERT_TRUE(parse_repo_url("https://github.com/axcap/Esp-GitHub-OTA", ref));
+  TEST_ASSERT_EQUAL_STRING("Esp-GitHub-OTA", ref.repo);
+  TEST_ASSERT_TRUE(parse_repo_url("axcap/Esp-GitHub-OTA/", ref));
+  TEST_ASSERT_EQUAL_STRING("Esp-GitHub-OTA", ref.repo);
+  TEST_ASSERT_FALSE(parse_repo_url("https://github.com/axcap", ref));
+}
+
+void test_tag_version()
+{
+  TEST_ASSERT_EQUAL_STRING("1.2.3", tag_version("v1.2.3"));
+  TEST_ASSERT_EQUAL_STRING("1.2.3", tag_version("fw-1.2.3"));
+  TEST_ASSERT_EQUAL_STRING("2.0.0-rc.1", tag_version("esp32s3-2.0.0-rc.1"));
+  TEST_ASSERT_EQUAL_STRING("1.2.3", tag_version("1.2.3"));
+  TEST_ASSERT_EQUAL_STRING("42", tag_version("build42"));
+  TEST_ASSERT_EQUAL_STRING("", tag_version("latest"));
+}
+
+// The String path this replaced: html_url rewritten with replace() into the
+// download base, the tag cut out again with lastIndexOf()
+static String string_path(const char *html_url, String &tag)
+{
+  String base_url = html_url;
+  base_url.replace("tag", "download");
+  base_url += "/";
+  int end = base_url.length() - 1;
+  tag = base_url.substring(base_url.lastIndexOf('/', end - 1) + 1, end);
+  return base_url;
+}
+
+void test_benchmark_against_string_replace()
+{
+  const char *html_url = "https://github.com/axcap/Esp-GitHub-OTA/releases/tag/v0.1.4";
+  const int rounds = 200000;
+  typedef std::chrono::steady_clock clock;
+  volatile size_t sink = 0;
+
+  uint32_t allocations = heap_allocations;
+  auto started = clock::now();
+  for (int i = 0; i < rounds; i++)
+  {
+    String tag;
+    String base_url = string_path(html_url, tag);
+    sink = sink + base_url.length() + tag.length();
+  }
+  auto string_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - started).count();
+  uint32_t string_allocations = heap_allocations - allocations;
+
+  allocations = heap_allocations;
+  started = clock::now();
+  for (int i = 0; i < rounds; i++)
+  {
+    release_ref_t ref;
+    char url[RELEASE_URL_SIZE];
+    parse_release_url(html_url, ref);
+    build_download_url(ref, "", url, sizeof(url));
+    sink = sink + strlen(url) + strlen(ref.tag);
+  }
+  auto parse_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - started).count();
+  uint32_t parse_allocations = heap_allocations - allocations;
+
+  // The host String keeps short strings inline, Arduino's String allocates
+  // for every copy, so the device pays more for the String path than this
+  char message[160];
+  snprintf(message, sizeof(message),
+           "String replace: %lld ns/op, %.1f allocations/op; parse_release_url: %lld ns/op, %.1f allocations/op",
+           (long long)(string_ns / rounds), (double)string_allocations / rounds,
+           (long long)(parse_ns / rounds), (double)parse_allocations / rounds);
+  TEST_MESSAGE(message);
+#ifdef __GLIBC__
+  TEST_ASSERT_EQUAL_UINT32(0, parse_allocations);
+  TEST_ASSERT_GREATER_THAN(0, string_allocations);
+#endif
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_parse_release_page_and_download_urls);
+  RUN_TEST(test_parse_names_containing_tag);
+  RUN_TEST(test_parse_tags_with_slashes);
+  RUN_TEST(test_reject_malformed_urls);
+  RUN_TEST(test_build_download_url_too_small);
+  RUN_TEST(test_parse_repo_urls);
+  RUN_TEST(test_tag_version);
+  RUN_TEST(test_benchmark_against_string_replace);
+  return UNITY_END();
+}
@@ -0,0 +1,2 @@
+// The C library the keys are checked against
+#include "semver.c"
@@ -0,0 +1,245 @@
+#include <chrono>
+#include <random>
+
+#include <unity.h>
+
+#include "arena.cpp"
+#include "semver_extensions.cpp"
+
+// SemVer 2.0 precedence examples, ascending, and prereleases longer than the
+// key holds that differ only past the cut
+static const char *ordered[] = {
+    "0.9.9",
+    "1.0.0-0.3.7",
+    "1.0.0-alpha",
+    "1.0.0-alpha.1",
+    "1.0.0-alpha.beta",
+    "1.0.0-beta",
+    "1.0.0-beta.2",
+    "1.0.0-beta.11",
+    "1.0.0-rc.1",
+    "1.0.0-x.7.z.92",
+    "1.0.0",
+    "1.0.1-nightly.20240101.1",
+    "1.0.1-nightly.20240101.2",
+    "1.0.1-nightly.20240101.10",
+    "1.0.1-nightlybuild-aaaa",
+    "1.0.1-nightlybuild-aaab",
+    "1.0.1",
+    "1.10.0",
+    "2.0.0",
+};
+static const size_t ordered_count = sizeof(ordered) / sizeof(ordered[0]);
+
+static int sign(int value)
+{
+  return (value > 0) - (value < 0);
+}
+
+// Reference: the C library's full parser and comparison
+static int reference_compare(const char *x, const char *y)
+{
+  semver_t a = {}, b = {};
+  TEST_ASSERT_EQUAL_INT(0, semver_parse(x, &a));
+  TEST_ASSERT_EQUAL_INT(0, semver_parse(y, &b));
+  int res = semver_compare(a, b);
+  semver_free(&a);
+  semver_free(&b);
+  return res;
+}
+
+static int key_compare(const char *x, const char *y)
+{
+  semver_t a = from_string(x), b = from_string(y);
+  semver_key_t ka, kb;
+  semver_key(a, ka);
+  semver_key(b, kb);
+  release_version(b);
+  release_version(a);
+  return semver_key_compare(ka, x, kb, y);
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_from_string_drops_build_metadata()
+{
+  semver_t version = from_string("1.2.3-rc.1+build.5");
+  TEST_ASSERT_EQUAL_INT(1, version.major);
+  TEST_ASSERT_EQUAL_INT(3, version.patch);
+  TEST_ASSERT_EQUAL_STRING("rc.1", version.prerelease);
+  release_version(version);
+
+  version = from_string("1.2.3+build.5");
+  TEST_ASSERT_NULL(version.prerelease);
+  release_version(version);
+
+  TEST_ASSERT_EQUAL_INT(0, key_compare("1.2.3-rc.1+build.5", "1.2.3-rc.1+build.6"));
+  TEST_ASSERT_EQUAL_INT(0, key_compare("1.2.3+a", "1.2.3"));
+}
+
+void test_keys_follow_precedence()
+{
+  for (size_t i = 0; i < ordered_count; i++)
+  {
+    for (size_t j = 0; j < ordered_count; j++)
+    {
+      int expected = i < j ? -1 : (i > j ? 1 : 0);
+      char message[96];
+      snprintf(message, sizeof(message), "%s vs %s", ordered[i], ordered[j]);
+      TEST_ASSERT_EQUAL_INT_MESSAGE(expected, sign(key_compare(ordered[i], ordered[j])), message);
+      TEST_ASSERT_EQUAL_INT_MESSAGE(expected, sign(reference_compare(ordered[i], ordered[j])), message);
+    }
+  }
+}
+
+void test_truncated_keys_are_flagged()
+{
+  semver_t version = from_string("1.0.1-nightlybuild-aaaa");
+  semver_key_t key;
+  semver_key(version, key);
+  release_version(version);
+  TEST_ASSERT_TRUE(semver_key_truncated(key));
+
+  version = from_string("1.0.0-beta.11");
+  semver_key(version, key);
+  release_version(version);
+  TEST_ASSERT_FALSE(semver_key_truncated(key));
+
+  // Without the versions keys equal up to the cut compare equal
+  semver_t a = from_string("1.0.1-nightlybuild-aaaa"), b = from_string("1.0.1-nightlybuild-aaab");
+  semver_key_t ka, kb;
+  semver_key(a, ka);
+  semver_key(b, kb);
+  release_version(b);
+  release_version(a);
+  TEST_ASSERT_EQUAL_INT(0, semver_key_compare(ka, kb));
+}
+
+// Random versions from a small alphabet, so prefixes and ties are common
+static std::string random_version(std::mt19937 &random)
+{
+  static const char *identifiers[] = {"alpha", "beta", "rc", "0", "1", "2", "10", "11", "nightly", "x-y", "longidentifier"};
+  std::string version = std::to_string(random() % 3) + "." + std::to_string(random() % 3) + "." + std::to_string(random() % 3);
+  size_t count = random() % 5;
+  for (size_t i = 0; i < count; i++)
+    version += (i == 0 ? "-" : ".") + std::string(identifiers[random() % 11]);
+  if (random() % 4 == 0)
+    version += "+build." + std::to_string(random() % 100);
+  return version;
+}
+
+void test_keys_match_semver_compare_on_random_versions()
+{
+  std::mt19937 random(42);
+  for (int i = 0; i < 20000; i++)
+  {
+    std::string x = random_version(random), y = random_version(random);
+    char message[160];
+    snprintf(message, sizeof(message), "%s vs %s", x.c_str(), y.c_str());
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sign(reference_compare(x.c_str(), y.c_str())),
+                                  sign(key_compare(x.c_str(), y.c_str())), message);
+  }
+}
+
+void test_rank_resolves_truncated_keys()
+{
+  const char *versions[] = {"1.0.1-nightlybuild-aaab", "1.0.0", "1.0.1-nightlybuild-aaaa", "1.0.1-nightlybuild-aaac"};
+  semver_key_t keys[4];
+  for (size_t i = 0; i < 4; i++)
+  {
+    semver_t version = from_string(versions[i]);
+    semver_key(version, keys[i]);
+    release_version(version);
+  }
+  uint16_t order[4];
+  semver_key_rank(keys, order, 4, versions);
+  TEST_ASSERT_EQUAL_UINT(3, order[0]);
+  TEST_ASSERT_EQUAL_UINT(0, order[1]);
+  TEST_ASSERT_EQUAL_UINT(2, order[2]);
+  TEST_ASSERT_EQUAL_UINT(1, order[3]);
+  TEST_ASSERT_EQUAL_INT(3, semver_key_max(keys, 4, versions));
+}
+
+// Ranking a release list: keys made once and compared with memcmp, against
+// semver_compare() on parsed versions and on versions parsed per comparison
+void test_benchmark_rank()
+{
+  const size_t count = 64;
+  const int rounds = 2000;
+  std::mt19937 random(7);
+  std::vector<std::string> strings;
+  std::vector<semver_t> parsed;
+  std::vector<semver_key_t> keys(count);
+  std::vector<const char *> versions;
+  for (size_t i = 0; i < count; i++)
+  {
+    // Tags without build metadata, as the releases of one repository
+    std::string version = random_version(random);
+    strings.push_back(version.substr(0, version.find('+')));
+  }
+  for (size_t i = 0; i < count; i++)
+  {
+    versions.push_back(strings[i].c_str());
+    parsed.push_back(from_string(strings[i].c_str()));
+    semver_key(parsed[i], keys[i]);
+  }
+
+  typedef std::chrono::steady_clock clock;
+  uint16_t order[count];
+  auto started = clock::now();
+  for (int r = 0; r < rounds; r++)
+    semver_key_rank(keys.data(), order, count, versions.data());
+  auto key_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - started).count();
+
+  started = clock::now();
+  for (int r = 0; r < rounds; r++)
+  {
+    for (size_t i = 0; i < count; i++)
+    {
+      size_t j = i;
+      for (; j > 0 && semver_compare(parsed[order[j - 1]], parsed[i]) < 0; j--)
+        order[j] = order[j - 1];
+      order[j] = i;
+    }
+  }
+  auto parsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - started).count();
+
+  started = clock::now();
+  for (int r = 0; r < rounds / 10; r++)
+  {
+    for (size_t i = 0; i < count; i++)
+    {
+      size_t j = i;
+      for (; j > 0 && reference_compare(versions[order[j - 1]], versions[i]) < 0; j--)
+        order[j] = order[j - 1];
+      order[j] = i;
+    }
+  }
+  auto reparse_ns = 10 * std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - started).count();
+
+  for (auto &version : parsed)
+    release_version(version);
+
+  char message[160];
+  snprintf(message, sizeof(message), "Ranking %u versions: keys %lld ns, semver_compare %lld ns, parse + compare %lld ns",
+           (unsigned)count, (long long)(key_ns / rounds), (long long)(parsed_ns / rounds), (long long)(reparse_ns / rounds));
+  TEST_MESSAGE(message);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_from_string_drops_build_metadata);
+  RUN_TEST(test_keys_follow_precedence);
+  RUN_TEST(test_truncated_keys_are_flagged);
+  RUN_TEST(test_keys_match_semver_compare_on_random_versions);
+  RUN_TEST(test_rank_resolves_truncated_keys);
+  RUN_TEST(test_benchmark_rank);
+  return UNITY_END();
+}
@@ -0,0 +1,299 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <unity.h>
+
+#include "arena.cpp"
+#include "throttle.cpp"
+#include "sha256.cpp"
+#include "sink.cpp"
+
+// The image arrives in TCP segment sized pieces, each readBytes() call and
+// where it stored the data are recorded. Sha256 has no host implementation,
+// digests are checked on the devices only.
+class SegmentStream : public Stream
+{
+public:
+  SegmentStream(const std::vector<uint8_t> &image, size_t segment) : _image(image), _segment(segment) {}
+
+  size_t write(uint8_t) override { return 0; }
+  int available() override { return std::min(_segment, _image.size() - _position); }
+  int read() override
+  {
+    byte_reads++;
+    return _position < _image.size() ? _image[_position++] : -1;
+  }
+  int peek() override { return _position < _image.size() ? _image[_position] : -1; }
+  size_t readBytes(char *buffer, size_t length) override
+  {
+    length = std::min(length, (size_t)available());
+    memcpy(buffer, _image.data() + _position, length);
+    _position += length;
+    targets.push_back((uint8_t *)buffer);
+    if (events)
+      *events += 'R';
+    return length;
+  }
+  using Print::write;
+
+  std::vector<uint8_t *> targets;
+  size_t byte_reads = 0;
+  // Shared with SlowSink, 'R' for every read
+  std::string *events = nullptr;
+
+private:
+  const std::vector<uint8_t> &_image;
+  size_t _segment;
+  size_t _position = 0;
+};
+
+// Takes every block whole and keeps a copy of the image
+class RecordingSink : public OtaSink
+{
+public:
+  bool begin(size_t size) override
+  {
+    image.clear();
+    return true;
+  }
+  size_t write(const uint8_t *data, size_t len) override
+  {
+    blocks.push_back(data);
+    lengths.push_back(len);
+    image.insert(image.end(), data, data + len);
+    return len;
+  }
+  bool finalize() override { return finalized = true; }
+  void abort() override { aborted = true; }
+
+  std::vector<uint8_t> image;
+  std::vector<const uint8_t *> blocks;
+  std::vector<size_t> lengths;
+  bool finalized = false;
+  bool aborted = false;
+};
+
+// Fills its own buffer in place, as PartitionWriter does with its sector
+class InPlaceSink : public RecordingSink
+{
+public:
+  uint8_t *reserve(size_t &len) override
+  {
+    len = std::min(len, sizeof(sector) - _buffered);
+    return sector + _buffered;
+  }
+  bool commit(size_t len) override
+  {
+    _buffered += len;
+    if (_buffered < sizeof(sector))
+      return true;
+    write(sector, _buffered);
+    _buffered = 0;
+    return true;
+  }
+  bool finalize() override
+  {
+    if (_buffered)
+      write(sector, _buffered);
+    return RecordingSink::finalize();
+  }
+
+  uint8_t sector[SINK_SECTOR_SIZE];
+
+private:
+  size_t _buffered = 0;
+};
+
+// A device that is busy for `busy_polls` calls before it takes each block,
+// and then only `accepts` bytes per call. Logs 'B' for every refusal and 'W'
+// for every write it takes.
+class SlowSink : public RecordingSink
+{
+public:
+  SlowSink(size_t busy_polls, size_t accepts) : _busy_polls(busy_polls), _accepts(accepts) {}
+
+  size_t write(const uint8_t *data, size_t len) override
+  {
+    if (_polls++ < _busy_polls)
+    {
+      events += 'B';
+      return 0;
+    }
+    len = std::min(len, _accepts);
+    if (len == 0)
+    {
+      events += 'B';
+      return 0;
+    }
+    events += 'W';
+    return RecordingSink::write(data, len);
+  }
+
+  // The next block is refused `_busy_polls` times again
+  void next_block() { _polls = 0; }
+
+  std::string events;
+
+private:
+  size_t _busy_polls;
+  size_t _accepts;
+  size_t _polls = 0;
+};
+
+static std::vector<uint8_t> make_image(size_t size)
+{
+  std::vector<uint8_t> image(size);
+  for (size_t i = 0; i < size; i++)
+    image[i] = (uint8_t)(i * 31 + (i >> 8));
+  return image;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_reads_land_in_sink_block()
+{
+  const size_t size = 3 * SINK_SECTOR_SIZE + 123, segment = 1460;
+  std::vector<uint8_t> image = make_image(size);
+  SegmentStream stream(image, segment);
+  RecordingSink sink;
+
+  TEST_ASSERT_TRUE(update_from_stream(stream, size, nullptr, sink));
+  TEST_ASSERT_TRUE(sink.finalized);
+  TEST_ASSERT_TRUE(sink.image == image);
+
+  // Whole blocks, the last one shorter, all from the same buffer
+  TEST_ASSERT_EQUAL_UINT(4, sink.blocks.size());
+  for (size_t i = 0; i < sink.blocks.size(); i++)
+  {
+    TEST_ASSERT_EQUAL_UINT(i < 3 ? SINK_SECTOR_SIZE : 123, sink.lengths[i]);
+    TEST_ASSERT_TRUE(sink.blocks[i] == sink.blocks[0]);
+  }
+
+  // Read in bulk straight into the block: no byte reads, at most one extra
+  // read per block where a segment straddles its end
+  TEST_ASSERT_EQUAL_UINT(0, stream.byte_reads);
+  TEST_ASSERT_TRUE(stream.targets.size() <= (size + segment - 1) / segment + sink.blocks.size());
+  for (uint8_t *target : stream.targets)
+    TEST_ASSERT_TRUE(target >= sink.blocks[0] && target < sink.blocks[0] + SINK_SECTOR_SIZE);
+}
+
+void test_reads_land_in_place()
+{
+  const size_t size = 2 * SINK_SECTOR_SIZE + 1000;
+  std::vector<uint8_t> image = make_image(size);
+  SegmentStream stream(image, 8192);
+  InPlaceSink sink;
+
+  TEST_ASSERT_TRUE(update_from_stream(stream, size, nullptr, sink));
+  TEST_ASSERT_TRUE(sink.image == image);
+
+  // A segment larger than the sector is read in sector sized pieces
+  TEST_ASSERT_EQUAL_UINT(3, stream.targets.size());
+  TEST_ASSERT_EQUAL_UINT(0, stream.byte_reads);
+  for (uint8_t *target : stream.targets)
+    TEST_ASSERT_TRUE(target == sink.sector);
+}
+
+void test_short_stream_cancels()
+{
+  const size_t size = 2 * SINK_SECTOR_SIZE;
+  std::vector<uint8_t> image = make_image(size - 100);
+  SegmentStream stream(image, 1460);
+  RecordingSink sink;
+
+  // The missing bytes time out on the simulated clock
+  TEST_ASSERT_FALSE(update_from_stream(stream, size, nullptr, sink));
+  TEST_ASSERT_TRUE(sink.aborted);
+  TEST_ASSERT_FALSE(sink.finalized);
+}
+
+// Nothing is read from the socket while the sink holds a block: between a
+// refusal and the end of that block only further writes happen
+void test_no_reads_while_sink_busy()
+{
+  const size_t size = 4 * SINK_SECTOR_SIZE + 500;
+  std::vector<uint8_t> image = make_image(size);
+  SegmentStream stream(image, 1460);
+  SlowSink sink(25, 1000);
+  stream.events = &sink.events;
+
+  // Reset the refusals at every read, so every block meets a busy device
+  struct Progress
+  {
+    static void on_progress(void *ctx, size_t current, size_t total, const update_stats_t &stats)
+    {
+      static_cast<SlowSink *>(ctx)->next_block();
+    }
+  };
+  update_control_t control = {false, false, 0, false, false, 1, nullptr, Progress::on_progress, &sink};
+
+  uint64_t started = host_now_us;
+  TEST_ASSERT_TRUE(update_from_stream(stream, size, nullptr, sink, &control));
+  TEST_ASSERT_TRUE(sink.image == image);
+
+  // Every block was written while the device was busy
+  const std::string &events = sink.events;
+  TEST_ASSERT_TRUE(events.find('B') != std::string::npos);
+  for (size_t i = events.find('B'); i != std::string::npos; i = events.find('B', i + 1))
+  {
+    size_t next = events.find_first_not_of('B', i);
+    TEST_ASSERT_TRUE_MESSAGE(next != std::string::npos && events[next] == 'W', "Read while the sink was busy");
+  }
+  // A block is written in pieces of at most 1000 bytes and nothing is read in
+  // between them
+  size_t block_start = 0;
+  for (size_t b = 0; b < 5; b++)
+  {
+    size_t first_write = events.find_first_of("BW", block_start);
+    size_t next_read = events.find('R', first_write);
+    std::string block = events.substr(first_write, next_read == std::string::npos ? std::string::npos : next_read - first_write);
+    TEST_ASSERT_TRUE(block.find('R') == std::string::npos);
+    TEST_ASSERT_EQUAL_UINT(b < 4 ? 5 : 1, std::count(block.begin(), block.end(), 'W'));
+    if (next_read == std::string::npos)
+      break;
+    block_start = next_read;
+  }
+
+  // The waits are accounted to the sink, 1 ms per refusal
+  TEST_ASSERT_EQUAL_UINT(std::count(events.begin(), events.end(), 'B'), sink.stalled_ms());
+  TEST_ASSERT_TRUE(host_now_us - started >= sink.stalled_ms() * 1000ULL);
+}
+
+// A sink that never takes data fails the download after
+// GITHUBOTA_SINK_TIMEOUT_MS, without reading the rest of the image
+void test_stuck_sink_times_out()
+{
+  const size_t size = 3 * SINK_SECTOR_SIZE;
+  std::vector<uint8_t> image = make_image(size);
+  SegmentStream stream(image, 1460);
+  SlowSink sink(0, 0);
+  stream.events = &sink.events;
+
+  uint64_t started = host_now_us;
+  TEST_ASSERT_FALSE(update_from_stream(stream, size, nullptr, sink));
+  TEST_ASSERT_TRUE(sink.aborted);
+  TEST_ASSERT_FALSE(sink.finalized);
+  TEST_ASSERT_TRUE(host_now_us - started >= GITHUBOTA_SINK_TIMEOUT_MS * 1000ULL);
+
+  // Only the first block was read
+  size_t reads = std::count(sink.events.begin(), sink.events.end(), 'R');
+  TEST_ASSERT_EQUAL_UINT((SINK_SECTOR_SIZE + 1459) / 1460, reads);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_reads_land_in_sink_block);
+  RUN_TEST(test_reads_land_in_place);
+  RUN_TEST(test_short_stream_cancels);
+  RUN_TEST(test_no_reads_while_sink_busy);
+  RUN_TEST(test_stuck_sink_times_out);
+  return UNITY_END();
+}
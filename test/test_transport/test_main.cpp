@@ -0,0 +1,126 @@
+#include <thread>
+#include <vector>
+
+#include <unity.h>
+
+#include "socket_transport.h"
+#include "transport.cpp"
+
+// Accepts connections and keeps them open until the test ends
+static int listener = -1;
+static uint16_t port = 0;
+static std::vector<int> connections;
+
+static void accept_loop()
+{
+  for (int fd; (fd = accept(listener, nullptr, nullptr)) >= 0;)
+    connections.push_back(fd);
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_single_client_reconnects_on_host_change()
+{
+  SocketClient client;
+  ClientTransport transport(client, false);
+
+  Client *api = transport.connect("127.0.0.1", port, false);
+  TEST_ASSERT_NOT_NULL(api);
+  transport.release(api, true);
+
+  Client *cdn = transport.connect("localhost", port, false);
+  TEST_ASSERT_NOT_NULL(cdn);
+  transport.release(cdn, true);
+
+  // The only slot went to the second host
+  api = transport.connect("127.0.0.1", port, false);
+  TEST_ASSERT_NOT_NULL(api);
+  TEST_ASSERT_FALSE(transport.last_connection_reused());
+  transport.release(api, false);
+  TEST_ASSERT_EQUAL_UINT32(3, transport.connections_opened());
+  TEST_ASSERT_EQUAL_UINT32(3, client.connects());
+}
+
+void test_added_clients_keep_both_hosts_open()
+{
+  SocketClient first, second;
+  ClientTransport transport(first, false);
+  TEST_ASSERT_TRUE(transport.add_client(second));
+
+  // API call, redirect to the CDN, then the next poll
+  for (int poll = 0; poll < 3; poll++)
+  {
+    Client *api = transport.connect("127.0.0.1", port, false);
+    TEST_ASSERT_NOT_NULL(api);
+    transport.release(api, true);
+
+    Client *cdn = transport.connect("localhost", port, false);
+    TEST_ASSERT_NOT_NULL(cdn);
+    TEST_ASSERT_TRUE(cdn != api);
+    transport.release(cdn, true);
+  }
+
+  TEST_ASSERT_EQUAL_UINT32(2, transport.connections_opened());
+  TEST_ASSERT_EQUAL_UINT32(4, transport.connections_reused());
+  TEST_ASSERT_EQUAL_UINT32(1, first.connects());
+  TEST_ASSERT_EQUAL_UINT32(1, second.connects());
+  transport.close_idle();
+}
+
+void test_add_client_beyond_pool_size()
+{
+  SocketClient clients[GITHUBOTA_POOL_SIZE + 1];
+  ClientTransport transport(clients[0], false);
+  for (size_t i = 1; i < GITHUBOTA_POOL_SIZE; i++)
+    TEST_ASSERT_TRUE(transport.add_client(clients[i]));
+  TEST_ASSERT_FALSE(transport.add_client(clients[GITHUBOTA_POOL_SIZE]));
+}
+
+void test_expired_connection_is_not_reused()
+{
+  SocketClient first, second;
+  ClientTransport transport(first, false);
+  transport.add_client(second);
+  transport.set_keep_alive(1000);
+
+  Client *api = transport.connect("127.0.0.1", port, false);
+  transport.release(api, true);
+  delay(1001);
+  api = transport.connect("127.0.0.1", port, false);
+  TEST_ASSERT_NOT_NULL(api);
+  TEST_ASSERT_FALSE(transport.last_connection_reused());
+  transport.release(api, false);
+}
+
+// Clients taken to do TLS are not handed out for http URLs
+void test_other_scheme_is_refused()
+{
+  SocketClient client;
+  ClientTransport transport(client);
+
+  TEST_ASSERT_NULL(transport.connect("127.0.0.1", port, false));
+  TEST_ASSERT_EQUAL_UINT32(0, client.connects());
+}
+
+int main()
+{
+  listener = host_listen(port);
+  if (listener < 0)
+    return 1;
+  std::thread server(accept_loop);
+  server.detach();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_single_client_reconnects_on_host_change);
+  RUN_TEST(test_added_clients_keep_both_hosts_open);
+  RUN_TEST(test_add_client_beyond_pool_size);
+  RUN_TEST(test_expired_connection_is_not_reused);
+  RUN_TEST(test_other_scheme_is_refused);
+  return UNITY_END();
+}
@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+"""Serve a test image on the LAN for the on-device download benchmarks.
+
+The image is random data of --size bytes at /image.bin, its SHA-256 as hex at
+/image.bin.sha256. The same data split into --files files is served for file
+sync as /filesystem.pack and /filesystem.manifest (see tools/fs_pack.py), the
+files named /bench/000.bin, /bench/001.bin and so on, with the manifest's
+SHA-256 at /filesystem.manifest.sha256. Range requests are answered with 206 like GitHub's release
+CDN, connections are kept alive, and --latency and --rate add a per-request
+delay and a per-connection bandwidth cap, so the effect of parallel streams
+over a slow WAN path can be measured without one.
+
+Run the benchmarks in test/test_device_download against it, e.g.
+
+  tools/bench_server.py --size 1048576 --latency 80 --rate 200000
+  PLATFORMIO_BUILD_FLAGS='-DBENCH_SSID=\\"lab\\" -DBENCH_PASS=\\"secret\\"
+    -DBENCH_URL=\\"http://192.168.1.10:8080/image.bin\\"' pio test -e esp32dev
+
+Usage: bench_server.py [--port N] [--size BYTES] [--files N] [--latency MS] [--rate BYTES/S]
+"""
+
+import argparse
+import hashlib
+import os
+import re
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+CHUNK = 1460
+
+
+def build_manifest(image, files):
+    """Manifest of the image split into `files` files, the image being the pack"""
+    lines = []
+    step = -(-len(image) // files)
+    for index, offset in enumerate(range(0, len(image), step)):
+        content = image[offset:offset + step]
+        digest = hashlib.sha256(content).hexdigest()
+        lines.append("%s %d %d /bench/%03d.bin\n" % (digest, offset, len(content), index))
+    return "".join(lines).encode()
+
+
+class BenchHandler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    image = b""
+    digest = ""
+    manifest = b""
+    latency = 0.0
+    rate = 0
+
+    def do_GET(self):
+        time.sleep(self.latency)
+        if self.path == "/image.bin.sha256":
+            self.send_body(200, self.digest.encode())
+            return
+        if self.path == "/filesystem.manifest":
+            self.send_body(200, self.manifest)
+            return
+        if self.path == "/filesystem.manifest.sha256":
+            self.send_body(200, hashlib.sha256(self.manifest).hexdigest().encode())
+            return
+        if self.path not in ("/image.bin", "/filesystem.pack"):
+            self.send_body(404, b"not found")
+            return
+
+        start, end = 0, len(self.image)
+        match = re.fullmatch(r"bytes=(\d+)-(\d*)", self.headers.get("Range", ""))
+        if match:
+            start = int(match.group(1))
+            end = int(match.group(2)) + 1 if match.group(2) else end
+            if start >= end or end > len(self.image):
+                self.send_body(416, b"")
+                return
+
+        self.send_response(206 if match else 200)
+        self.send_header("Content-Length", str(end - start))
+        if match:
+            self.send_header("Content-Range", f"bytes {start}-{end - 1}/{len(self.image)}")
+        self.end_headers()
+
+        # Paced per connection, concurrent connections each get the full rate
+        sent, began = 0, time.monotonic()
+        while start + sent < end:
+            chunk = self.image[start + sent:min(start + sent + CHUNK, end)]
+            self.wfile.write(chunk)
+            sent += len(chunk)
+            if self.rate:
+                ahead = sent / self.rate - (time.monotonic() - began)
+                if ahead > 0:
+                    time.sleep(ahead)
+
+    def send_body(self, status, body):
+        self.send_response(status)
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def log_message(self, format, *args):
+        print(f"{self.client_address[0]} {format % args}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--size", type=int, default=1024 * 1024, help="image size in bytes")
+    parser.add_argument("--files", type=int, default=64, help="files the image is split into for file sync")
+    parser.add_argument("--latency", type=float, default=0, help="delay before every response in ms")
+    parser.add_argument("--rate", type=int, default=0, help="bytes/s per connection, 0 for unlimited")
+    args = parser.parse_args()
+
+    BenchHandler.image = os.urandom(args.size)
+    BenchHandler.digest = hashlib.sha256(BenchHandler.image).hexdigest()
+    BenchHandler.manifest = build_manifest(BenchHandler.image, args.files)
+    BenchHandler.latency = args.latency / 1000
+    BenchHandler.rate = args.rate
+
+    print(f"Serving {args.size} bytes, sha256 {BenchHandler.digest}, on port {args.port}")
+    ThreadingHTTPServer(("", args.port), BenchHandler).serve_forever()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,44 @@
+#!/usr/bin/env python3
+"""Build the pack and manifest used by GitHubFsOTA::enable_file_sync().
+
+The pack is the plain concatenation of every file below the data directory,
+the manifest lists one file per line:
+
+    <sha256 hex> <offset in pack> <size> <path>
+
+Upload both as release assets next to (or instead of) filesystem.bin.
+
+Usage: fs_pack.py [data_dir] [output_dir]
+"""
+
+import hashlib
+import os
+import sys
+
+
+def build(data_dir, out_dir, manifest_name="filesystem.manifest", pack_name="filesystem.pack"):
+    lines = []
+    offset = 0
+    with open(os.path.join(out_dir, pack_name), "wb") as pack:
+        for root, dirs, files in os.walk(data_dir):
+            dirs.sort()
+            for name in sorted(files):
+                path = os.path.join(root, name)
+                with open(path, "rb") as f:
+                    content = f.read()
+                fs_path = "/" + os.path.relpath(path, data_dir).replace(os.sep, "/")
+                digest = hashlib.sha256(content).hexdigest()
+                lines.append("%s %d %d %s\n" % (digest, offset, len(content), fs_path))
+                pack.write(content)
+                offset += len(content)
+
+    with open(os.path.join(out_dir, manifest_name), "w", newline="\n") as manifest:
+        manifest.writelines(lines)
+
+    print("%d files, %d bytes packed" % (len(lines), offset))
+
+
+if __name__ == "__main__":
+    data_dir = sys.argv[1] if len(sys.argv) > 1 else "data"
+    out_dir = sys.argv[2] if len(sys.argv) > 2 else "."
+    build(data_dir, out_dir)
@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""Compile the CA certificates trusted for GitHub traffic into src/trust_anchors.h.
+
+Every *.pem file in the certificate directory may hold one or more root
+certificates. They are emitted twice:
+
+  * as DER for the BearSSL trust anchors on ESP8266, which skips the PEM
+    decoding at runtime
+  * as a bundle in the ESP-IDF certificate bundle format for ESP32, which
+    is used in place from flash and only looked up during the handshake
+
+Rotating CAs is a matter of changing the certificate directory and
+rerunning this script.
+
+Usage: gen_trust_anchors.py [cert_dir] [output_header]
+       gen_trust_anchors.py --spki cert.pem...   print SPKI SHA-256 pins
+"""
+
+import base64
+import glob
+import hashlib
+import os
+import re
+import struct
+import sys
+
+PEM_RE = re.compile(r"-----BEGIN CERTIFICATE-----(.+?)-----END CERTIFICATE-----", re.S)
+
+
+def read_pem(path):
+    with open(path) as f:
+        text = f.read()
+    return [base64.b64decode("".join(body.split())) for body in PEM_RE.findall(text)]
+
+
+def der_element(data, pos):
+    """Return (start, content_start, end) of the DER element at pos."""
+    length = data[pos + 1]
+    content = pos + 2
+    if length & 0x80:
+        count = length & 0x7F
+        length = int.from_bytes(data[content:content + count], "big")
+        content += count
+    return pos, content, content + length
+
+
+def subject_and_spki(der):
+    _, cert, _ = der_element(der, 0)
+    _, pos, _ = der_element(der, cert)  # TBSCertificate
+    fields = []
+    while len(fields) < 7:
+        start, _, end = der_element(der, pos)
+        fields.append(der[start:end])
+        pos = end
+    # Skip the optional explicit [0] version
+    if fields[0][0] == 0xA0:
+        fields = fields[1:]
+    # serial, signature, issuer, validity, subject, subjectPublicKeyInfo
+    return fields[4], fields[5]
+
+
+def c_array(name, data, progmem):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append("  " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    return "static const uint8_t %s[]%s = {\n%s\n};\n" % (name, " PROGMEM" if progmem else "", "\n".join(lines))
+
+
+def build(cert_dir, out_path):
+    certs = []
+    for path in sorted(glob.glob(os.path.join(cert_dir, "*.pem"))):
+        for der in read_pem(path):
+            certs.append((os.path.splitext(os.path.basename(path))[0], der))
+
+    out = [
+        "// Generated by tools/gen_trust_anchors.py from %s, do not edit.\n" % cert_dir.replace(os.sep, "/"),
+        "#ifndef GITHUBOTA_TRUST_ANCHORS_H\n",
+        "#define GITHUBOTA_TRUST_ANCHORS_H\n\n",
+        "#include <Arduino.h>\n\n",
+        "#define TRUST_ANCHOR_COUNT %d\n\n" % len(certs),
+        "#ifdef ESP8266\n",
+    ]
+    for i, (name, der) in enumerate(certs):
+        out.append("// %s\n" % name)
+        out.append(c_array("trust_anchor_%d" % i, der, True))
+    out.append("\nstruct trust_anchor_t\n{\n  const uint8_t *der;\n  uint16_t size;\n};\n\n")
+    out.append("static const trust_anchor_t trust_anchors[TRUST_ANCHOR_COUNT] = {\n")
+    for i, (_, der) in enumerate(certs):
+        out.append("  {trust_anchor_%d, %d},\n" % (i, len(der)))
+    out.append("};\n")
+
+    # ESP-IDF bundle: certificate count, then subject and public key of each
+    # certificate sorted by subject for the binary search in esp_crt_bundle
+    entries = sorted(subject_and_spki(der) for _, der in certs)
+    bundle = struct.pack(">H", len(entries))
+    for subject, spki in entries:
+        bundle += struct.pack(">HH", len(subject), len(spki)) + subject + spki
+    out.append("#elif defined(ESP32)\n")
+    out.append("// %s\n" % ", ".join(name for name, _ in certs))
+    out.append(c_array("trust_bundle", bundle, False))
+    out.append("#define TRUST_BUNDLE_SIZE %d\n" % len(bundle))
+    out.append("#endif\n\n#endif\n")
+
+    with open(out_path, "w", newline="\n") as f:
+        f.writelines(out)
+    print("%d certificates, %d bytes of bundle" % (len(certs), len(bundle)))
+
+
+def print_pins(paths):
+    for path in paths:
+        for der in read_pem(path):
+            _, spki = subject_and_spki(der)
+            print("%s %s" % (hashlib.sha256(spki).hexdigest(), path))
+
+
+if __name__ == "__main__":
+    if len(sys.argv) > 1 and sys.argv[1] == "--spki":
+        print_pins(sys.argv[2:])
+    else:
+        root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+        cert_dir = sys.argv[1] if len(sys.argv) > 1 else os.path.relpath(os.path.join(root, "tools", "certs"))
+        out_path = sys.argv[2] if len(sys.argv) > 2 else os.path.join(root, "src", "trust_anchors.h")
+        build(cert_dir, out_path)